@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <cstring>
+
+#include <eda/cost.hpp>
+#include <eda/eda.hpp>
+#include <eda/resampling.hpp>
+
+/// Prints the static cost of the example graphs.
+///
+/// Usage: `eda_cost [name]`, where `name` selects a single graph.
+
+namespace {
+
+  using namespace eda;
+  using namespace eda::syntax;
+
+  std::array<float, 4> params = {};
+
+  auto echo_graph()
+  {
+    auto& [time_samples, filter_a, feedback, dry_wet_mix] = params;
+    ABlock<2, 1> auto const filter = (_ << (_, _), _) | (((_ * _, (1 - _) * _) | plus) % _);
+    ABlock<1, 1> auto const echo = (plus | delay(ref(time_samples))) % (filter(ref(filter_a)) * ref(feedback));
+    return _ << (echo * ref(dry_wet_mix)) + (_ * (1 - ref(dry_wet_mix)));
+  }
+
+  auto tanh_graph()
+  {
+    return oversample<8>(_ * ref(params[0]) | eda::tanh);
+  }
+
+  auto halfband_graph()
+  {
+    return _ | eda::halfband;
+  }
+
+  void print(const char* name, const Cost& c)
+  {
+    std::printf("%-10s %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %10zu %10zu %10zu\n", name, c.adds, c.muls, c.calls,
+                c.macs, c.copies, c.ops(), c.state_bytes, c.history_bytes, c.scratch_bytes);
+  }
+
+  template<AnyBlock Block>
+  void report(const char* filter, const char* name)
+  {
+    if (filter != nullptr && std::strcmp(filter, name) != 0) return;
+    print(name, cost<Block>);
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  std::printf("%-10s %8s %8s %8s %8s %8s %8s %10s %10s %10s\n", "block", "adds", "muls", "calls", "macs", "copies",
+              "ops", "state", "history", "scratch");
+  report<decltype(echo_graph())>(filter, "echo");
+  report<decltype(tanh_graph())>(filter, "tanh");
+  report<decltype(halfband_graph())>(filter, "halfband");
+  return 0;
+}
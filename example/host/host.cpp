@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <eda/eda.hpp>
+#include <eda/resampling.hpp>
+#include <eda/rt_host.hpp>
+
+/// Runs an example graph in a simulated real-time host, and prints its timing statistics as JSON.
+///
+/// Usage: `eda_host name [sample_rate] [buffer_size] [callbacks]`. Exits with status 1 if any callback
+/// missed its deadline, so it can gate a CI job.
+
+namespace {
+
+  using namespace eda;
+  using namespace eda::syntax;
+
+  float gain = 0.5f;
+
+  auto tanh_graph()
+  {
+    return oversample<8>(_ * ref(gain) | eda::tanh);
+  }
+
+  auto halfband_graph()
+  {
+    return _ | eda::halfband;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::fprintf(stderr, "Usage: %s tanh|halfband [sample_rate] [buffer_size] [callbacks]\n", argv[0]);
+    return 2;
+  }
+  HostOptions options;
+  if (argc > 2) options.sample_rate = std::atof(argv[2]);
+  if (argc > 3) options.buffer_size = std::strtoul(argv[3], nullptr, 10);
+  if (argc > 4) options.callbacks = std::strtoul(argv[4], nullptr, 10);
+
+  HostStats stats;
+  if (std::strcmp(argv[1], "tanh") == 0) {
+    stats = simulate_host(tanh_graph(), options);
+  } else if (std::strcmp(argv[1], "halfband") == 0) {
+    stats = simulate_host(halfband_graph(), options);
+  } else {
+    std::fprintf(stderr, "Unknown graph %s\n", argv[1]);
+    return 2;
+  }
+  stats.write_json(std::cout);
+  return stats.xruns == 0 ? 0 : 1;
+}
@@ -1,5 +1,9 @@
 #pragma once
+#include <array>
 #include <concepts>
+#include <optional>
+
+#include <eda/evaluator.hpp>
 
 #include "lv2/core/lv2.h"
 
@@ -45,3 +49,79 @@ LV2_Descriptor make_descriptor(const char* uri)
   };
 }
 
+/// Description of a plugin built from an EDA block.
+///
+/// `parameters` lists the symbols of the control ports, and `block` builds the
+/// block from an array of parameter values, typically using `ref(params[i])`.
+template<typename T>
+concept LV2Graph = requires(std::array<float, T::parameters.size()>& params)
+{
+  { T::uri } -> std::convertible_to<const char*>;
+  { T::block(params) } -> eda::AnyBlock;
+};
+
+/// Plugin generated from an `LV2Graph`.
+///
+/// Ports are numbered with the control ports first, in the order of `Graph::parameters`,
+/// followed by one audio input port per block input, and one audio output port per block
+/// output. Blocks with latency (see `eda::latency`) get one more control output port, last,
+/// which reports it to the host, and should be declared with `lv2:reportsLatency`.
+///
+/// `run` copies the control ports once, and processes the host's audio buffers directly
+/// through the block's buffer path. Input and output ports may be the same buffer.
+template<LV2Graph Graph>
+struct LV2BlockPlugin final : LV2Plugin {
+  static constexpr std::size_t n_params = Graph::parameters.size();
+  using params_t = std::array<float, n_params>;
+  using block_t = decltype(Graph::block(std::declval<params_t&>()));
+  static constexpr std::size_t n_ins = eda::ins<block_t>;
+  static constexpr std::size_t n_outs = eda::outs<block_t>;
+  static constexpr std::size_t latency = eda::latency<block_t>;
+  static constexpr std::size_t latency_port = n_params + n_ins + n_outs;
+
+  LV2BlockPlugin() = default;
+
+  void connect_port(uint32_t port, float* data) override
+  {
+    if (port < n_params) {
+      param_ports_[port] = data;
+    } else if (port < n_params + n_ins) {
+      in_ports_[port - n_params] = data;
+    } else if (port < n_params + n_ins + n_outs) {
+      out_ports_[port - n_params - n_ins] = data;
+    } else if (latency > 0 && port == latency_port) {
+      latency_port_ = data;
+    }
+  }
+
+  void activate() override
+  {
+    eval_.emplace(Graph::block(params_));
+  }
+
+  void run(uint32_t n_samples) override
+  {
+    for (std::size_t i = 0; i < n_params; i++) {
+      params_[i] = *param_ports_[i];
+    }
+    eda::process(*eval_, eda::BufferView<n_ins>(in_ports_, n_samples), eda::BufferView<n_outs>(out_ports_, n_samples));
+    if (latency_port_ != nullptr) *latency_port_ = static_cast<float>(latency);
+  }
+
+private:
+  /// Referenced by the evaluator, so the plugin must not be moved
+  params_t params_ = {};
+  std::optional<eda::evaluator<block_t>> eval_;
+
+  std::array<float*, n_params> param_ports_ = {};
+  std::array<float*, n_ins> in_ports_ = {};
+  std::array<float*, n_outs> out_ports_ = {};
+  float* latency_port_ = nullptr;
+};
+
+/// Make the LV2 descriptor of a plugin generated from `Graph`
+template<LV2Graph Graph>
+LV2_Descriptor make_lv2_plugin()
+{
+  return make_descriptor<LV2BlockPlugin<Graph>>(Graph::uri);
+}
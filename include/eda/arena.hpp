@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+
+namespace eda {
+
+  // ARENA EVALUATOR ///////////////////////////////////
+
+  /// An evaluator whose state lives in one cache line aligned allocation.
+  ///
+  /// The evaluator itself, which holds all the small state touched every frame, like
+  /// recursive memory, filter state and indices, is placed at the start of the arena.
+  /// The history buffers of all delay lines follow it, each starting on its own cache
+  /// line. The arena is sized when the evaluator is created, and delays allocate their
+  /// whole capacity up front, so evaluating never allocates.
+  template<AnyBlock Block>
+  struct ArenaEvaluator {
+    explicit ArenaEvaluator(const Block& block) : ArenaEvaluator(evaluator<Block>(block)) {}
+
+    /// Moves the state of `e` into a new arena
+    explicit ArenaEvaluator(evaluator<Block> e)
+    {
+      std::size_t bytes = padded_bytes(sizeof(evaluator<Block>));
+      history_offset_ = bytes;
+      for_each_history(e, [&bytes](auto& h) { bytes += padded_bytes(h.bytes()); });
+      arena_ = std::make_unique<CacheLine[]>(bytes / sizeof(CacheLine));
+      size_ = bytes;
+
+      eval_ = new (arena_.get()) evaluator<Block>(std::move(e));
+      std::byte* next = data() + history_offset_;
+      for_each_history(*eval_, [&next](auto& h) {
+        h.bind(next);
+        next += padded_bytes(h.bytes());
+      });
+    }
+
+    ArenaEvaluator(const ArenaEvaluator& rhs) : ArenaEvaluator(evaluator<Block>(*rhs.eval_)) {}
+    ArenaEvaluator(ArenaEvaluator&& rhs) noexcept
+      : arena_(std::move(rhs.arena_)),
+        eval_(std::exchange(rhs.eval_, nullptr)),
+        size_(rhs.size_),
+        history_offset_(rhs.history_offset_)
+    {}
+    ArenaEvaluator& operator=(ArenaEvaluator rhs) noexcept
+    {
+      std::swap(arena_, rhs.arena_);
+      std::swap(eval_, rhs.eval_);
+      std::swap(size_, rhs.size_);
+      std::swap(history_offset_, rhs.history_offset_);
+      return *this;
+    }
+
+    ~ArenaEvaluator()
+    {
+      if (eval_ != nullptr) eval_->~evaluator<Block>();
+    }
+
+    Frame<outs<Block>> eval(Frame<ins<Block>> in)
+    {
+      return eval_->eval(in);
+    }
+
+    /// Called by `eda::process`, like the `process` member of other evaluators
+    void process(BufferView<ins<Block>> in, BufferView<outs<Block>> out)
+    {
+      detail::process_buffer(*eval_, in, out);
+    }
+
+    void begin_buffer(std::size_t n)
+    {
+      detail::begin_buffer(*eval_, n);
+    }
+
+    void end_buffer()
+    {
+      detail::end_buffer(*eval_);
+    }
+
+    /// Reset all state, clearing all history with a single `memset`
+    void reset() noexcept
+    {
+      std::memset(data() + history_offset_, 0, size_ - history_offset_);
+      detail::reset(*eval_, false);
+    }
+
+    bool quiescent() const
+    {
+      return is_quiescent(*eval_);
+    }
+
+    std::size_t tail_length() const
+    {
+      return eda::tail_length(*eval_);
+    }
+
+    evaluator<Block>& operator*() noexcept
+    {
+      return *eval_;
+    }
+
+    evaluator<Block>* operator->() noexcept
+    {
+      return eval_;
+    }
+
+    /// Total size of the arena in bytes
+    [[nodiscard]] std::size_t bytes() const noexcept
+    {
+      return size_;
+    }
+
+    /// Size of the history part of the arena in bytes
+    [[nodiscard]] std::size_t history_bytes() const noexcept
+    {
+      return size_ - history_offset_;
+    }
+
+  private:
+    static constexpr std::size_t padded_bytes(std::size_t bytes) noexcept
+    {
+      return (bytes + sizeof(CacheLine) - 1) / sizeof(CacheLine) * sizeof(CacheLine);
+    }
+
+    std::byte* data() noexcept
+    {
+      return reinterpret_cast<std::byte*>(arena_.get());
+    }
+
+    std::unique_ptr<CacheLine[]> arena_;
+    evaluator<Block>* eval_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t history_offset_ = 0;
+  };
+
+  template<typename T>
+  struct block_for<ArenaEvaluator<T>> {
+    using type = T;
+  };
+
+  /// Make an evaluator with all its state in one contiguous allocation
+  template<AnyBlockRef T>
+  auto make_arena_evaluator(T&& b)
+  {
+    return ArenaEvaluator<std::remove_cvref_t<T>>(b);
+  }
+
+} // namespace eda
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <ranges>
 #include <span>
 
 #include "eda/frame.hpp"
 #include "eda/internal/util.hpp"
+#include "eda/storage.hpp"
 
 namespace eda {
 
@@ -293,12 +295,13 @@ namespace eda {
 
   /// Fixed size memory block.
   ///
-  /// Outputs its input delayed by n samples
-  template<std::size_t Samples = 1>
-  struct Mem : BlockBase<Mem<Samples>, 1, 1> {};
+  /// Outputs its input delayed by n samples. The history is stored in the
+  /// format `Storage`, see `ASampleStorage`.
+  template<std::size_t Samples = 1, ASampleStorage Storage = storage::f32>
+  struct Mem : BlockBase<Mem<Samples, Storage>, 1, 1> {};
 
-  template<std::size_t Samples = 1>
-  constexpr Mem<Samples> mem;
+  template<std::size_t Samples = 1, ASampleStorage Storage = storage::f32>
+  constexpr Mem<Samples, Storage> mem;
 
   /// Delay output of block by 1 sample
   template<AnyBlock Block>
@@ -309,12 +312,61 @@ namespace eda {
 
   // DELAY /////////////////////////////////////////////
 
+  /// Capacity of delays created without one, over a second at 48kHz
+  constexpr std::size_t default_delay_capacity = 1 << 16;
+
   /// Variable size memory block.
   ///
-  /// Given input signals `(d, x)`, outputs `x` delayed by `d` samples
-  struct Delay : BlockBase<Delay, 2, 1> {};
+  /// Given input signals `(d, x)`, outputs `x` delayed by `d` samples. The history
+  /// is stored in the format `Storage`, see `ASampleStorage`.
+  ///
+  /// Memory for `capacity` samples, or `default_delay_capacity` if it is zero, is
+  /// allocated up front, and longer delays are clamped.
+  template<ASampleStorage Storage = storage::f32>
+  struct BasicDelay : BlockBase<BasicDelay<Storage>, 2, 1> {
+    std::size_t capacity = 0;
+  };
+
+  using Delay = BasicDelay<>;
+  /// Delay of at most `default_delay_capacity` samples.
+  ///
+  /// Each evaluator of it preallocates the whole history, 256 KiB with the default `f32` storage.
+  /// Use `fixed_delay` for delays that are shorter, or that must be longer.
   constexpr Delay delay;
 
+  /// Delay which stores its history in the format `Storage`
+  template<ASampleStorage Storage>
+  constexpr BasicDelay<Storage> delay_as;
+
+  /// Delay of at most `capacity` samples
+  template<ASampleStorage Storage = storage::f32>
+  constexpr BasicDelay<Storage> fixed_delay(std::size_t capacity) noexcept
+  {
+    return {{}, capacity};
+  }
+
+  // MULTITAP //////////////////////////////////////////
+
+  /// Delay line with several read taps.
+  ///
+  /// Given input signals `(d_0, ..., d_{Taps - 1}, x)`, outputs `x` delayed by each of the
+  /// `d_t` samples. All taps read from a single history, which is written once per frame,
+  /// where `Taps` separate delays would each keep a copy. Otherwise like `BasicDelay`.
+  template<std::size_t Taps, ASampleStorage Storage = storage::f32>
+  struct MultiTap : BlockBase<MultiTap<Taps, Storage>, Taps + 1, Taps> {
+    std::size_t capacity = 0;
+  };
+
+  template<std::size_t Taps, ASampleStorage Storage = storage::f32>
+  constexpr MultiTap<Taps, Storage> multitap;
+
+  /// Multi-tap delay of at most `capacity` samples
+  template<std::size_t Taps, ASampleStorage Storage = storage::f32>
+  constexpr MultiTap<Taps, Storage> fixed_multitap(std::size_t capacity) noexcept
+  {
+    return {{}, capacity};
+  }
+
   // FUNCTION ////////////////////////////////////////// $\label{code:extra_block}$
 
   /// Adapt a function to a block
@@ -367,4 +419,613 @@ namespace eda {
     return FIRFilter<N>{.kernel = kernel};
   }
 
+  // STATELESS /////////////////////////////////////////
+
+  /// Whether the output of a block only depends on its current input and the values of its `Ref`s.
+  ///
+  /// Conservatively false for blocks that are not known to be stateless.
+  template<AnyBlock T>
+  struct is_stateless : std::false_type {};
+
+  template<AnyBlock T>
+  constexpr bool is_stateless_v = is_stateless<T>::value;
+
+  template<>
+  struct is_stateless<Literal> : std::true_type {};
+  template<>
+  struct is_stateless<Ref> : std::true_type {};
+  template<std::size_t N>
+  struct is_stateless<Ident<N>> : std::true_type {};
+  template<std::size_t N>
+  struct is_stateless<Cut<N>> : std::true_type {};
+  template<>
+  struct is_stateless<Plus> : std::true_type {};
+  template<>
+  struct is_stateless<Minus> : std::true_type {};
+  template<>
+  struct is_stateless<Times> : std::true_type {};
+  template<>
+  struct is_stateless<Divide> : std::true_type {};
+  template<ASampleStorage Storage>
+  struct is_stateless<Mem<0, Storage>> : std::true_type {};
+
+  /// Functions without inputs are generators, and are not assumed to be pure
+  template<std::size_t In, std::size_t Out, util::Callable<Frame<Out>(Frame<In>)> F>
+  requires std::copyable<F>
+  struct is_stateless<FunBlock<In, Out, F>> : std::bool_constant<(In > 0)> {};
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  struct is_stateless<Partial<Block, Inputs...>>
+    : std::bool_constant<is_stateless_v<Block> && (is_stateless_v<Inputs> && ...)> {};
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct is_stateless<Parallel<Lhs, Rhs>> : std::bool_constant<is_stateless_v<Lhs> && is_stateless_v<Rhs>> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct is_stateless<Sequential<Lhs, Rhs>> : std::bool_constant<is_stateless_v<Lhs> && is_stateless_v<Rhs>> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct is_stateless<Split<Lhs, Rhs>> : std::bool_constant<is_stateless_v<Lhs> && is_stateless_v<Rhs>> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct is_stateless<Merge<Lhs, Rhs>> : std::bool_constant<is_stateless_v<Lhs> && is_stateless_v<Rhs>> {};
+
+  // CONTROL RATE //////////////////////////////////////
+
+  /// Whether a block only depends on `Ref` and `Literal` leaves.
+  ///
+  /// Such blocks have no inputs, and their output can only change when a referenced
+  /// parameter changes, so they can be evaluated once per buffer instead of once per frame.
+  template<typename T>
+  concept AControlRateBlock = AnyBlock<T> && (ins<T> == 0) && is_stateless_v<T>;
+
+  /// Control rate block whose value is linearly interpolated between buffers.
+  ///
+  /// When processing buffers, the output ramps from the value at the end of the previous
+  /// buffer to the current value over the course of the buffer. When evaluated one
+  /// frame at a time, outputs the current value of `Block` directly.
+  template<AControlRateBlock Block>
+  struct Smooth : CompositionBase<Smooth<Block>, 0, outs<Block>, Block> {};
+
+  /// Smooth changes to a control rate block
+  template<AnyBlockRef Block>
+  constexpr auto smooth(Block&& b) noexcept
+  {
+    return Smooth<std::remove_cvref_t<Block>>{{FWD(b)}};
+  }
+
+  template<AnyBlock Block>
+  struct is_stateless<Smooth<Block>> : std::true_type {};
+
+  /// Whether a `Smooth` block appears anywhere in `T`
+  template<typename T>
+  struct contains_smooth : std::false_type {};
+
+  template<typename T>
+  constexpr bool contains_smooth_v = contains_smooth<T>::value;
+
+  template<typename... Ts>
+  struct contains_smooth<std::tuple<Ts...>> : std::bool_constant<(contains_smooth_v<Ts> || ...)> {};
+
+  template<AComposition T>
+  struct contains_smooth<T> : contains_smooth<operands_t<T>> {};
+
+  template<AControlRateBlock Block>
+  struct contains_smooth<Smooth<Block>> : std::true_type {};
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  struct contains_smooth<Partial<Block, Inputs...>>
+    : std::bool_constant<contains_smooth_v<Block> || (contains_smooth_v<Inputs> || ...)> {};
+
+  // AFFINITY //////////////////////////////////////////
+
+  /// How a signal computed by a block depends on some signal `s`, and on the other inputs.
+  ///
+  /// Ordered from the least to the most dependent.
+  enum struct Dependency {
+    /// Depends on neither `s` nor the other inputs, only on literals and parameters
+    constant,
+    /// Depends on the other inputs, but not on `s`
+    varying,
+    /// Of the form `a * s + b`, where `a` is constant and `b` varying
+    linear,
+    /// Of the form `a * s + b`, where `a` and `b` are varying
+    affine,
+    nonlinear,
+  };
+
+  template<std::size_t N>
+  using Dependencies = std::array<Dependency, N>;
+
+  /// Propagates how the inputs of a block depend on some signal to its outputs.
+  ///
+  /// Conservatively makes all outputs nonlinear in the signal when any input depends
+  /// on it, for blocks that are not known to be affine. The outputs of blocks with state
+  /// vary over time, even with constant inputs.
+  template<AnyBlock T>
+  struct affinity {
+    static constexpr Dependencies<outs<T>> apply(Dependencies<ins<T>> in) noexcept
+    {
+      auto most = is_stateless_v<T> ? Dependency::constant : Dependency::varying;
+      for (auto d : in) most = std::max(most, d);
+      Dependencies<outs<T>> res;
+      res.fill(most > Dependency::varying ? Dependency::nonlinear : most);
+      return res;
+    }
+  };
+
+  namespace detail {
+    /// Dependency of a sum
+    constexpr Dependency add_dependencies(Dependency a, Dependency b) noexcept
+    {
+      return std::max(a, b);
+    }
+
+    /// Dependency of a product
+    constexpr Dependency mul_dependencies(Dependency a, Dependency b) noexcept
+    {
+      if (a == Dependency::constant) return b;
+      if (b == Dependency::constant) return a;
+      if (a > Dependency::varying && b > Dependency::varying) return Dependency::nonlinear;
+      const auto most = std::max(a, b);
+      // A varying factor makes the coefficient of `s` varying
+      if (most == Dependency::linear) return Dependency::affine;
+      return most;
+    }
+
+    /// Dependency of a quotient
+    constexpr Dependency div_dependencies(Dependency a, Dependency b) noexcept
+    {
+      if (b > Dependency::varying) return Dependency::nonlinear;
+      return mul_dependencies(a, b);
+    }
+
+    template<std::size_t Begin, std::size_t End, std::size_t N>
+    constexpr Dependencies<End - Begin> slice_dependencies(const Dependencies<N>& d) noexcept
+    {
+      Dependencies<End - Begin> res;
+      std::copy(d.begin() + Begin, d.begin() + End, res.begin());
+      return res;
+    }
+
+    template<std::size_t N, std::size_t M>
+    constexpr Dependencies<N + M> concat_dependencies(const Dependencies<N>& a, const Dependencies<M>& b) noexcept
+    {
+      Dependencies<N + M> res;
+      std::copy(b.begin(), b.end(), std::copy(a.begin(), a.end(), res.begin()));
+      return res;
+    }
+  } // namespace detail
+
+  /// Dependencies of the outputs of `T` given the dependencies of its inputs
+  template<AnyBlock T>
+  constexpr Dependencies<outs<T>> propagate_dependencies(Dependencies<ins<T>> in) noexcept
+  {
+    return affinity<T>::apply(in);
+  }
+
+  template<std::size_t N>
+  struct affinity<Ident<N>> {
+    static constexpr Dependencies<N> apply(Dependencies<N> in) noexcept
+    {
+      return in;
+    }
+  };
+  template<ASampleStorage Storage>
+  struct affinity<Mem<0, Storage>> {
+    static constexpr Dependencies<1> apply(Dependencies<1> in) noexcept
+    {
+      return in;
+    }
+  };
+  template<>
+  struct affinity<Plus> {
+    static constexpr Dependencies<1> apply(Dependencies<2> in) noexcept
+    {
+      return {detail::add_dependencies(in[0], in[1])};
+    }
+  };
+  template<>
+  struct affinity<Minus> : affinity<Plus> {};
+  template<>
+  struct affinity<Times> {
+    static constexpr Dependencies<1> apply(Dependencies<2> in) noexcept
+    {
+      return {detail::mul_dependencies(in[0], in[1])};
+    }
+  };
+  template<>
+  struct affinity<Divide> {
+    static constexpr Dependencies<1> apply(Dependencies<2> in) noexcept
+    {
+      return {detail::div_dependencies(in[0], in[1])};
+    }
+  };
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  struct affinity<Partial<Block, Inputs...>> {
+    static constexpr Dependencies<outs<Block>> apply(Dependencies<ins<Partial<Block, Inputs...>>> in) noexcept
+    {
+      return propagate_dependencies<Block>(apply_inputs<Inputs...>(in));
+    }
+
+  private:
+    template<AnyBlock Input, AnyBlock... Rest, std::size_t N>
+    static constexpr auto apply_inputs(const Dependencies<N>& in) noexcept
+    {
+      auto res = propagate_dependencies<Input>(detail::slice_dependencies<0, ins<Input>>(in));
+      auto rest = detail::slice_dependencies<ins<Input>, N>(in);
+      if constexpr (sizeof...(Rest) == 0) {
+        return detail::concat_dependencies(res, rest);
+      } else {
+        return detail::concat_dependencies(res, apply_inputs<Rest...>(rest));
+      }
+    }
+  };
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct affinity<Parallel<Lhs, Rhs>> {
+    static constexpr Dependencies<outs<Lhs> + outs<Rhs>> apply(Dependencies<ins<Lhs> + ins<Rhs>> in) noexcept
+    {
+      return detail::concat_dependencies(
+        propagate_dependencies<Lhs>(detail::slice_dependencies<0, ins<Lhs>>(in)),
+        propagate_dependencies<Rhs>(detail::slice_dependencies<ins<Lhs>, ins<Lhs> + ins<Rhs>>(in)));
+    }
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct affinity<Sequential<Lhs, Rhs>> {
+    static constexpr Dependencies<outs<Rhs>> apply(Dependencies<ins<Lhs>> in) noexcept
+    {
+      return propagate_dependencies<Rhs>(propagate_dependencies<Lhs>(in));
+    }
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct affinity<Split<Lhs, Rhs>> {
+    static constexpr Dependencies<outs<Rhs>> apply(Dependencies<ins<Lhs>> in) noexcept
+    {
+      const auto l = propagate_dependencies<Lhs>(in);
+      Dependencies<ins<Rhs>> r;
+      for (std::size_t i = 0; i < ins<Rhs>; i++) r[i] = l[i % outs<Lhs>];
+      return propagate_dependencies<Rhs>(r);
+    }
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct affinity<Merge<Lhs, Rhs>> {
+    static constexpr Dependencies<outs<Rhs>> apply(Dependencies<ins<Lhs>> in) noexcept
+    {
+      const auto l = propagate_dependencies<Lhs>(in);
+      Dependencies<ins<Rhs>> r = {};
+      for (std::size_t i = 0; i < outs<Lhs>; i++) {
+        r[i % ins<Rhs>] = detail::add_dependencies(r[i % ins<Rhs>], l[i]);
+      }
+      return propagate_dependencies<Rhs>(r);
+    }
+  };
+
+  namespace detail {
+    /// How the fed back signal and the outputs of `rec(Lhs, Rhs)` depend on the previous value of the fed back signal
+    template<AnyBlock Lhs, AnyBlock Rhs>
+    constexpr Dependency recurrence_dependency = [] {
+      if constexpr (outs<Rhs> != 1 || !is_stateless_v<Lhs> || !is_stateless_v<Rhs>) {
+        return Dependency::nonlinear;
+      } else {
+        Dependencies<ins<Lhs>> in;
+        in.fill(Dependency::varying);
+        in[0] = Dependency::linear;
+        const auto l = propagate_dependencies<Lhs>(in);
+        const auto r = propagate_dependencies<Rhs>(detail::slice_dependencies<0, ins<Rhs>>(l));
+        auto res = r[0];
+        for (auto d : l) res = std::max(res, d);
+        return res;
+      }
+    }();
+  } // namespace detail
+
+  /// Whether `rec(Lhs, Rhs)` is a linear recurrence with constant coefficients, which can be solved
+  /// for a whole buffer at once.
+  ///
+  /// That is when a single channel is fed back, `Lhs` and `Rhs` are stateless, and both the fed
+  /// back signal and the outputs are linear in the previous value of the fed back signal, with
+  /// coefficients that only depend on literals and parameters.
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr bool is_linear_recurrence_v = detail::recurrence_dependency<Lhs, Rhs> <= Dependency::linear;
+
+  /// Whether `rec(Lhs, Rhs)` is an affine recurrence, which can also be solved for a whole buffer at once.
+  ///
+  /// Like `is_linear_recurrence_v`, but the coefficients may also depend on the inputs, like the
+  /// coefficient of a one pole filter whose cutoff is modulated by an input signal.
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr bool is_affine_recurrence_v = detail::recurrence_dependency<Lhs, Rhs> <= Dependency::affine;
+
+  // LATENCY ///////////////////////////////////////////
+
+  /// Number of frames by which the output of a block lags behind its input.
+  ///
+  /// Only counts the group delay of processing, like the `(N - 1) / 2` of a linear phase `FIRFilter<N>`,
+  /// or the block size of an FFT. Delays that are part of the signal, like a `Mem` in a comb filter
+  /// or an echo, and variable delays, feedback paths and other leaves have none.
+  /// Specialize for blocks that add latency of their own.
+  template<AnyBlock T>
+  struct block_latency : std::integral_constant<std::size_t, 0> {};
+
+  template<AnyBlockRef T>
+  constexpr std::size_t latency = block_latency<std::remove_cvref_t<T>>::value;
+
+  /// `Mem<N>`, added by `compensate_latency` to line a branch up with a later one.
+  ///
+  /// Unlike a plain `Mem`, counts as latency, so compensating twice adds nothing.
+  template<std::size_t N>
+  struct Compensation : CompositionBase<Compensation<N>, 1, 1, Mem<N>> {};
+
+  template<std::size_t N>
+  struct block_latency<Compensation<N>> : std::integral_constant<std::size_t, N> {};
+  template<std::size_t N>
+  struct block_latency<FIRFilter<N>> : std::integral_constant<std::size_t, (N - 1) / 2> {};
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  struct block_latency<Partial<Block, Inputs...>>
+    : std::integral_constant<std::size_t, latency<Block> + std::max({latency<Inputs>...})> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_latency<Parallel<Lhs, Rhs>> : std::integral_constant<std::size_t, std::max(latency<Lhs>, latency<Rhs>)> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_latency<Sequential<Lhs, Rhs>> : std::integral_constant<std::size_t, latency<Lhs> + latency<Rhs>> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_latency<Split<Lhs, Rhs>> : std::integral_constant<std::size_t, latency<Lhs> + latency<Rhs>> {};
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_latency<Merge<Lhs, Rhs>> : std::integral_constant<std::size_t, latency<Lhs> + latency<Rhs>> {};
+  /// The fed back signal does not delay the forward path
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_latency<Recursive<Lhs, Rhs>> : std::integral_constant<std::size_t, latency<Lhs>> {};
+
+  namespace detail {
+    /// Delay all outputs of `block` by `N` frames
+    template<std::size_t N, AnyBlock Block>
+    constexpr auto delay_outputs(const Block& block) noexcept
+    {
+      if constexpr (N == 0 || outs<Block> == 0) {
+        return block;
+      } else {
+        return seq(block, repeat_par<outs<Block>>(Compensation<N>{{mem<N>}}));
+      }
+    }
+  } // namespace detail
+
+  /// Add delays to the branches of `block` with less latency, so parallel branches line up.
+  ///
+  /// Branches of `Parallel` blocks, and the inputs of partially applied blocks, are each
+  /// delayed by a `Compensation` to match the branch with the most latency. Intentional delays,
+  /// like the `Mem` of a comb filter, have no latency, so they are left as they are. The total latency of
+  /// `block` is unchanged, and applying this twice has no further effect.
+  template<AnyBlock Block>
+  constexpr auto compensate_latency(const Block& block) noexcept
+  {
+    return block;
+  }
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr auto compensate_latency(const Parallel<Lhs, Rhs>& block) noexcept
+  {
+    auto lhs = compensate_latency(std::get<0>(block.operands));
+    auto rhs = compensate_latency(std::get<1>(block.operands));
+    constexpr auto max = std::max(latency<decltype(lhs)>, latency<decltype(rhs)>);
+    return par(detail::delay_outputs<max - latency<decltype(lhs)>>(lhs),
+               detail::delay_outputs<max - latency<decltype(rhs)>>(rhs));
+  }
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  constexpr auto compensate_latency(const Partial<Block, Inputs...>& block) noexcept
+  {
+    auto inner = compensate_latency(block.block);
+    return std::apply(
+      [&](const auto&... inputs) {
+        constexpr auto max = std::max({latency<Inputs>...});
+        // Inputs that are not applied pass straight through to the block
+        constexpr auto rest = ins<Block> - (outs<Inputs> + ...);
+        auto aligned = [](const auto& in) {
+          return detail::delay_outputs<max - latency<decltype(in)>>(in);
+        };
+        if constexpr (rest > 0 && max > 0) {
+          return inner(aligned(compensate_latency(inputs))..., repeat_par<rest>(Compensation<max>{{mem<max>}}));
+        } else {
+          return inner(aligned(compensate_latency(inputs))...);
+        }
+      },
+      block.inputs);
+  }
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr auto compensate_latency(const Sequential<Lhs, Rhs>& block) noexcept
+  {
+    return seq(compensate_latency(std::get<0>(block.operands)), compensate_latency(std::get<1>(block.operands)));
+  }
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr auto compensate_latency(const Split<Lhs, Rhs>& block) noexcept
+  {
+    return split(compensate_latency(std::get<0>(block.operands)), compensate_latency(std::get<1>(block.operands)));
+  }
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr auto compensate_latency(const Merge<Lhs, Rhs>& block) noexcept
+  {
+    return merge(compensate_latency(std::get<0>(block.operands)), compensate_latency(std::get<1>(block.operands)));
+  }
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr auto compensate_latency(const Recursive<Lhs, Rhs>& block) noexcept
+  {
+    return rec(compensate_latency(std::get<0>(block.operands)), compensate_latency(std::get<1>(block.operands)));
+  }
+
+  // SILENCE ///////////////////////////////////////////
+
+  /// Which of a number of signals are known to be silent
+  template<std::size_t N>
+  using Silences = std::array<bool, N>;
+
+  /// Propagates which inputs of a block are silent to its outputs, starting from silent state.
+  ///
+  /// Conservatively assumes the outputs are not silent, for blocks that are not known to keep
+  /// silence. Functions can't be told apart by type, and `cos` doesn't, where `sin` does.
+  template<AnyBlock T>
+  struct silence {
+    static constexpr Silences<outs<T>> apply(Silences<ins<T>>) noexcept
+    {
+      return {};
+    }
+  };
+
+  namespace detail {
+    template<std::size_t Begin, std::size_t End, std::size_t N>
+    constexpr Silences<End - Begin> slice_silences(const Silences<N>& s) noexcept
+    {
+      Silences<End - Begin> res;
+      std::copy(s.begin() + Begin, s.begin() + End, res.begin());
+      return res;
+    }
+
+    template<std::size_t N, std::size_t M>
+    constexpr Silences<N + M> concat_silences(const Silences<N>& a, const Silences<M>& b) noexcept
+    {
+      Silences<N + M> res;
+      std::copy(b.begin(), b.end(), std::copy(a.begin(), a.end(), res.begin()));
+      return res;
+    }
+  } // namespace detail
+
+  /// Silence of the outputs of `T` given the silence of its inputs
+  template<AnyBlock T>
+  constexpr Silences<outs<T>> propagate_silence(Silences<ins<T>> in) noexcept
+  {
+    return silence<T>::apply(in);
+  }
+
+  template<std::size_t N>
+  struct silence<Ident<N>> {
+    static constexpr Silences<N> apply(Silences<N> in) noexcept
+    {
+      return in;
+    }
+  };
+  template<std::size_t Samples, ASampleStorage Storage>
+  struct silence<Mem<Samples, Storage>> : silence<Ident<1>> {};
+  template<std::size_t N>
+  struct silence<Compensation<N>> : silence<Ident<1>> {};
+  template<std::size_t N>
+  struct silence<FIRFilter<N>> : silence<Ident<1>> {};
+  template<ASampleStorage Storage>
+  struct silence<BasicDelay<Storage>> {
+    static constexpr Silences<1> apply(Silences<2> in) noexcept
+    {
+      return {in[1]};
+    }
+  };
+  template<std::size_t Taps, ASampleStorage Storage>
+  struct silence<MultiTap<Taps, Storage>> {
+    static constexpr Silences<Taps> apply(Silences<Taps + 1> in) noexcept
+    {
+      Silences<Taps> res;
+      res.fill(in[Taps]);
+      return res;
+    }
+  };
+  template<>
+  struct silence<Plus> {
+    static constexpr Silences<1> apply(Silences<2> in) noexcept
+    {
+      return {in[0] && in[1]};
+    }
+  };
+  template<>
+  struct silence<Minus> : silence<Plus> {};
+  template<>
+  struct silence<Times> {
+    static constexpr Silences<1> apply(Silences<2> in) noexcept
+    {
+      return {in[0] || in[1]};
+    }
+  };
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  struct silence<Partial<Block, Inputs...>> {
+    static constexpr Silences<outs<Block>> apply(Silences<ins<Partial<Block, Inputs...>>> in) noexcept
+    {
+      return propagate_silence<Block>(apply_inputs<Inputs...>(in));
+    }
+
+  private:
+    template<AnyBlock Input, AnyBlock... Rest, std::size_t N>
+    static constexpr auto apply_inputs(const Silences<N>& in) noexcept
+    {
+      auto res = propagate_silence<Input>(detail::slice_silences<0, ins<Input>>(in));
+      auto rest = detail::slice_silences<ins<Input>, N>(in);
+      if constexpr (sizeof...(Rest) == 0) {
+        return detail::concat_silences(res, rest);
+      } else {
+        return detail::concat_silences(res, apply_inputs<Rest...>(rest));
+      }
+    }
+  };
+
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct silence<Parallel<Lhs, Rhs>> {
+    static constexpr Silences<outs<Lhs> + outs<Rhs>> apply(Silences<ins<Lhs> + ins<Rhs>> in) noexcept
+    {
+      return detail::concat_silences(propagate_silence<Lhs>(detail::slice_silences<0, ins<Lhs>>(in)),
+                                     propagate_silence<Rhs>(detail::slice_silences<ins<Lhs>, ins<Lhs> + ins<Rhs>>(in)));
+    }
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct silence<Sequential<Lhs, Rhs>> {
+    static constexpr Silences<outs<Rhs>> apply(Silences<ins<Lhs>> in) noexcept
+    {
+      return propagate_silence<Rhs>(propagate_silence<Lhs>(in));
+    }
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct silence<Split<Lhs, Rhs>> {
+    static constexpr Silences<outs<Rhs>> apply(Silences<ins<Lhs>> in) noexcept
+    {
+      const auto l = propagate_silence<Lhs>(in);
+      Silences<ins<Rhs>> r;
+      for (std::size_t i = 0; i < ins<Rhs>; i++) r[i] = l[i % outs<Lhs>];
+      return propagate_silence<Rhs>(r);
+    }
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct silence<Merge<Lhs, Rhs>> {
+    static constexpr Silences<outs<Rhs>> apply(Silences<ins<Lhs>> in) noexcept
+    {
+      const auto l = propagate_silence<Lhs>(in);
+      Silences<ins<Rhs>> r;
+      r.fill(true);
+      for (std::size_t i = 0; i < outs<Lhs>; i++) r[i % ins<Rhs>] = r[i % ins<Rhs>] && l[i];
+      return propagate_silence<Rhs>(r);
+    }
+  };
+  /// The fed back signal starts out silent, and stays so when `Rhs` keeps it silent
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct silence<Recursive<Lhs, Rhs>> {
+    static constexpr Silences<outs<Lhs>> apply(Silences<ins<Recursive<Lhs, Rhs>>> in) noexcept
+    {
+      Silences<outs<Rhs>> fed_back;
+      fed_back.fill(true);
+      // Each round only clears channels, so this settles within `outs<Rhs>` rounds
+      for (std::size_t i = 0; i <= outs<Rhs>; i++) {
+        const auto l = propagate_silence<Lhs>(detail::concat_silences(fed_back, in));
+        const auto r = propagate_silence<Rhs>(detail::slice_silences<0, ins<Rhs>>(l));
+        for (std::size_t c = 0; c < outs<Rhs>; c++) fed_back[c] = fed_back[c] && r[c];
+      }
+      return propagate_silence<Lhs>(detail::concat_silences(fed_back, in));
+    }
+  };
+
+  /// Whether `rec(Lhs, Rhs)` keeps the fed back signal silent, given silent input.
+  ///
+  /// It doesn't when it feeds back a constant, like `(plus | (_ + 1)) % _`.
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  constexpr bool rests_at_zero_v = [] {
+    Silences<ins<Lhs>> in;
+    in.fill(true);
+    const auto r = propagate_silence<Rhs>(detail::slice_silences<0, ins<Rhs>>(propagate_silence<Lhs>(in)));
+    return std::ranges::all_of(r, [](bool s) { return s; });
+  }();
+
 } // namespace eda
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "eda/frame.hpp"
+
+namespace eda {
+
+  // BUFFER VIEW ///////////////////////////////////////
+
+  /// Non-owning view of `Channels` channel buffers of `size()` samples each.
+  ///
+  /// Channels are stored as separate pointers, so views can be sliced and
+  /// concatenated without copying, and several channels may point to the same data.
+  template<std::size_t Channels>
+  struct BufferView {
+    constexpr BufferView() = default;
+    constexpr BufferView(std::array<float*, Channels> channels, std::size_t size) noexcept
+      : channels_(channels), size_(size)
+    {}
+
+    static constexpr std::size_t channels()
+    {
+      return Channels;
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    /// Pointer to the samples of channel `c`
+    [[nodiscard]] constexpr float* operator[](std::size_t c) const noexcept
+    {
+      return channels_[c];
+    }
+
+    [[nodiscard]] constexpr const std::array<float*, Channels>& channel_ptrs() const noexcept
+    {
+      return channels_;
+    }
+
+    /// Gather frame `i` from all channels
+    [[nodiscard]] constexpr Frame<Channels> frame(std::size_t i) const noexcept
+    {
+      Frame<Channels> res;
+      // `Frame<0>` has no elements to index
+      if constexpr (Channels > 0) {
+        for (std::size_t c = 0; c < Channels; c++) {
+          res[c] = channels_[c][i];
+        }
+      }
+      return res;
+    }
+
+    /// Scatter `f` to frame `i` of all channels
+    constexpr void set_frame(std::size_t i, Frame<Channels> f) const noexcept
+    {
+      if constexpr (Channels > 0) {
+        for (std::size_t c = 0; c < Channels; c++) {
+          channels_[c][i] = f[c];
+        }
+      }
+    }
+
+    /// View of the samples [offset; offset + size[ of all channels
+    [[nodiscard]] constexpr BufferView subview(std::size_t offset, std::size_t size) const noexcept
+    {
+      BufferView res = *this;
+      for (auto& ch : res.channels_) ch += offset;
+      res.size_ = size;
+      return res;
+    }
+
+  private:
+    std::array<float*, Channels> channels_ = {};
+    std::size_t size_ = 0;
+  };
+
+  template<std::size_t N>
+  BufferView(std::array<float*, N>, std::size_t) -> BufferView<N>;
+
+  /// Get the channels [Begin; End[ of a buffer view.
+  ///
+  /// If End is negative, count `-End` elements from the end of the array.
+  template<std::ptrdiff_t Begin, std::ptrdiff_t End, std::size_t Channels>
+  requires(Begin >= 0 && ((End >= Begin && End <= Channels))) //
+    constexpr auto slice(const BufferView<Channels>& in)
+  {
+    std::array<float*, End - Begin> res;
+    std::copy(in.channel_ptrs().begin() + Begin, in.channel_ptrs().begin() + End, res.begin());
+    return BufferView<End - Begin>(res, in.size());
+  }
+
+  template<std::ptrdiff_t Begin, std::ptrdiff_t End, std::size_t Channels>
+  requires(Begin >= 0 && End < 0 && (Channels + End + 1) >= Begin) //
+    constexpr auto slice(const BufferView<Channels>& in)          //
+  {
+    return slice<Begin, Channels + End + 1, Channels>(in);
+  }
+
+  /// Concatenate the channels of two buffer views of the same size
+  template<std::size_t S1, std::size_t S2>
+  constexpr auto concat(const BufferView<S1>& x1, const BufferView<S2>& x2) -> BufferView<S1 + S2>
+  {
+    std::array<float*, S1 + S2> res;
+    auto b2 = std::copy(x1.channel_ptrs().begin(), x1.channel_ptrs().end(), res.begin());
+    std::copy(x2.channel_ptrs().begin(), x2.channel_ptrs().end(), b2);
+    return BufferView<S1 + S2>(res, std::max(x1.size(), x2.size()));
+  }
+
+  // AUDIO BUFFER //////////////////////////////////////
+
+  /// A cache line of samples. Used as the unit of allocation for aligned sample storage
+  struct alignas(64) CacheLine {
+    static constexpr std::size_t samples = 64 / sizeof(float);
+    std::array<float, samples> data;
+  };
+
+  /// `size` rounded up to a whole number of cache lines
+  constexpr std::size_t padded_size(std::size_t size) noexcept
+  {
+    return (size + CacheLine::samples - 1) / CacheLine::samples * CacheLine::samples;
+  }
+
+  /// Owning storage for `Channels` channels of `size()` samples each.
+  ///
+  /// Every channel starts on its own cache line, with the channel stride padded to a
+  /// whole number of cache lines, so SIMD kernels can use aligned loads on all channels.
+  template<std::size_t Channels>
+  struct AudioBuffer {
+    AudioBuffer() = default;
+    explicit AudioBuffer(std::size_t size) : size_(size), data_(Channels * padded_size(size) / CacheLine::samples) {}
+
+    static constexpr std::size_t channels()
+    {
+      return Channels;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    /// Distance in samples between the start of two channels
+    [[nodiscard]] std::size_t stride() const noexcept
+    {
+      return padded_size(size_);
+    }
+
+    [[nodiscard]] float* operator[](std::size_t c) noexcept
+    {
+      return reinterpret_cast<float*>(data_.data()) + c * stride();
+    }
+
+    [[nodiscard]] BufferView<Channels> view() noexcept
+    {
+      std::array<float*, Channels> ptrs;
+      for (std::size_t c = 0; c < Channels; c++) ptrs[c] = (*this)[c];
+      return {ptrs, size_};
+    }
+
+    operator BufferView<Channels>() noexcept
+    {
+      return view();
+    }
+
+  private:
+    std::size_t size_ = 0;
+    std::vector<CacheLine> data_;
+  };
+
+  // SCRATCH BUFFER ////////////////////////////////////
+
+  /// Number of frames processed at a time by compositions that need intermediate buffers
+  constexpr std::size_t process_chunk = 64;
+
+  /// Fixed size, uninitialized storage for `process_chunk` frames of `Channels` channels.
+  ///
+  /// Meant to live on the stack of a `process` call, so buffer processing never allocates.
+  template<std::size_t Channels>
+  struct ScratchBuffer {
+    [[nodiscard]] BufferView<Channels> view(std::size_t size = process_chunk) noexcept
+    {
+      std::array<float*, Channels> ptrs;
+      for (std::size_t c = 0; c < Channels; c++) ptrs[c] = data_.data() + c * process_chunk;
+      return {ptrs, size};
+    }
+
+  private:
+    alignas(64) std::array<float, Channels * process_chunk> data_;
+  };
+
+  /// Whether any channel of `a` shares memory with any channel of `b`
+  template<std::size_t S1, std::size_t S2>
+  constexpr bool overlaps(const BufferView<S1>& a, const BufferView<S2>& b) noexcept
+  {
+    for (float* x : a.channel_ptrs()) {
+      for (float* y : b.channel_ptrs()) {
+        if (x < y + b.size() && y < x + a.size()) return true;
+      }
+    }
+    return false;
+  }
+
+} // namespace eda
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "eda/block.hpp"
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/internal/cpu.hpp"
+#include "eda/internal/fft.hpp"
+
+namespace eda {
+
+  // CONVOLUTION KERNEL ////////////////////////////////
+
+  /// Spectra of an impulse response cut into partitions of `BlockSize` samples.
+  ///
+  /// Each partition is zero padded to `2 * BlockSize` samples before its transform, as needed
+  /// for overlap-save. Computed once when the kernel is loaded, and shared by all evaluators.
+  template<std::size_t BlockSize>
+  struct ConvolutionKernel {
+    static_assert(std::has_single_bit(BlockSize) && BlockSize >= 2, "BlockSize must be a power of two");
+
+    static constexpr std::size_t bins = BlockSize + 1;
+
+    explicit ConvolutionKernel(std::span<const float> kernel)
+      : plan(std::make_shared<const util::FFTPlan>(2 * BlockSize)),
+        length(kernel.size()),
+        partitions(std::max<std::size_t>(1, (kernel.size() + BlockSize - 1) / BlockSize)),
+        re(partitions * bins),
+        im(re.size())
+    {
+      util::RealFFT fft(plan);
+      std::vector<float> frame(2 * BlockSize);
+      // The inverse transform is not normalized, so scale the kernel instead
+      const float scale = 1.f / fft.size();
+      for (std::size_t p = 0; p < partitions; p++) {
+        const auto part = kernel.subspan(p * BlockSize, std::min(BlockSize, kernel.size() - p * BlockSize));
+        std::ranges::fill(frame, 0.f);
+        std::ranges::transform(part, frame.begin(), [scale](float x) { return x * scale; });
+        fft.forward(frame.data(), re.data() + p * bins, im.data() + p * bins);
+      }
+    }
+
+    /// Tables for the transforms of all evaluators
+    std::shared_ptr<const util::FFTPlan> plan;
+    /// Number of samples of the impulse response
+    std::size_t length;
+    /// Number of partitions of `BlockSize` samples, at least one
+    std::size_t partitions;
+    /// Real and imaginary parts of the spectra of all partitions, one after the other
+    std::vector<float> re;
+    std::vector<float> im;
+  };
+
+  // CONVOLUTION ///////////////////////////////////////
+
+  /// Convolves its input with an impulse response, using uniformly partitioned overlap-save FFT convolution.
+  ///
+  /// Works on blocks of `BlockSize` samples, which adds `BlockSize` samples of latency, but costs
+  /// `O(log(BlockSize) + length / BlockSize)` per sample, where `FIRFilter` costs `O(length)`.
+  template<std::size_t BlockSize = process_chunk>
+  struct Convolution : BlockBase<Convolution<BlockSize>, 1, 1> {
+    std::shared_ptr<const ConvolutionKernel<BlockSize>> kernel;
+  };
+
+  /// Convolution with an impulse response known at runtime, see `Convolution`
+  template<std::size_t BlockSize = process_chunk>
+  Convolution<BlockSize> convolve(std::span<const float> kernel)
+  {
+    return {{}, std::make_shared<const ConvolutionKernel<BlockSize>>(kernel)};
+  }
+
+  template<std::size_t BlockSize>
+  struct block_latency<Convolution<BlockSize>> : std::integral_constant<std::size_t, BlockSize> {};
+
+  template<std::size_t BlockSize>
+  struct evaluator<Convolution<BlockSize>> : EvaluatorBase<Convolution<BlockSize>> {
+    static constexpr std::size_t bins = ConvolutionKernel<BlockSize>::bins;
+
+    evaluator(const Convolution<BlockSize>& c)
+      : kernel_(c.kernel),
+        fft_(kernel_->plan),
+        input_(2 * BlockSize),
+        output_(2 * BlockSize),
+        delay_re_(kernel_->partitions * bins),
+        delay_im_(delay_re_.size()),
+        sum_re_(bins),
+        sum_im_(bins),
+        multiply_add_(kernels.select())
+    {}
+
+    Frame<1> eval(Frame<1> in)
+    {
+      const float res = output_[BlockSize + fill_];
+      input_[BlockSize + fill_] = in[0];
+      silent_ = std::abs(in[0]) <= silence_threshold ? detail::saturating_add(silent_, 1) : 0;
+      if (++fill_ == BlockSize) convolve_block();
+      return res;
+    }
+
+    /// Copies whole runs of the buffer at once, up to the end of the current block.
+    /// `in` and `out` may be the same buffer
+    void process(BufferView<1> in, BufferView<1> out)
+    {
+      for (std::size_t i = 0; i < in.size();) {
+        const auto n = std::min(BlockSize - fill_, in.size() - i);
+        silent_ = detail::count_silent(in[0] + i, n, silent_);
+        std::copy_n(in[0] + i, n, input_.data() + BlockSize + fill_);
+        std::copy_n(output_.data() + BlockSize + fill_, n, out[0] + i);
+        fill_ += n;
+        i += n;
+        if (fill_ == BlockSize) convolve_block();
+      }
+    }
+
+    void reset() noexcept
+    {
+      std::ranges::fill(input_, 0.f);
+      std::ranges::fill(output_, 0.f);
+      std::ranges::fill(delay_re_, 0.f);
+      std::ranges::fill(delay_im_, 0.f);
+      fill_ = 0;
+      newest_ = 0;
+      silent_ = infinite_tail;
+    }
+
+    /// Once the input frame and the whole frequency domain delay line hold silent samples
+    bool quiescent() const noexcept
+    {
+      return silent_ >= tail_length();
+    }
+
+    std::size_t tail_length() const noexcept
+    {
+      return (kernel_->partitions + 2) * BlockSize;
+    }
+
+  private:
+    /// Transform the input frame into the delay line, and multiply-accumulate it with the kernel
+    void convolve_block() noexcept
+    {
+      const auto partitions = kernel_->partitions;
+      newest_ = newest_ == 0 ? partitions - 1 : newest_ - 1;
+      fft_.forward(input_.data(), delay_re_.data() + newest_ * bins, delay_im_.data() + newest_ * bins);
+      std::ranges::fill(sum_re_, 0.f);
+      std::ranges::fill(sum_im_, 0.f);
+      // Partition `p` of the kernel applies to the spectrum `p` blocks back, which is `p` slots
+      // after the newest in the ring
+      for (std::size_t p = 0; p < partitions; p++) {
+        const auto slot = (newest_ + p) % partitions;
+        multiply_add_(sum_re_.data(), sum_im_.data(), delay_re_.data() + slot * bins, delay_im_.data() + slot * bins,
+                      kernel_->re.data() + p * bins, kernel_->im.data() + p * bins);
+      }
+      fft_.inverse(sum_re_.data(), sum_im_.data(), output_.data());
+      // The first half of the output is circular aliasing, the second half is the next block
+      std::copy_n(input_.data() + BlockSize, BlockSize, input_.data());
+      fill_ = 0;
+    }
+
+    using kernel = void (*)(float*, float*, const float*, const float*, const float*, const float*) noexcept;
+
+    /// Add the complex product of `x` and `h` to `s`
+    static void multiply_add(float* __restrict sr,
+                             float* __restrict si,
+                             const float* __restrict xr,
+                             const float* __restrict xi,
+                             const float* __restrict hr,
+                             const float* __restrict hi) noexcept
+    {
+      for (std::size_t k = 0; k < bins; k++) {
+        sr[k] += xr[k] * hr[k] - xi[k] * hi[k];
+        si[k] += xr[k] * hi[k] + xi[k] * hr[k];
+      }
+    }
+
+    EDA_TARGET_AVX2 static void multiply_add_avx2(float* sr,
+                                                  float* si,
+                                                  const float* xr,
+                                                  const float* xi,
+                                                  const float* hr,
+                                                  const float* hi) noexcept
+    {
+      multiply_add(sr, si, xr, xi, hr, hi);
+    }
+
+    EDA_TARGET_AVX512 static void multiply_add_avx512(float* sr,
+                                                      float* si,
+                                                      const float* xr,
+                                                      const float* xi,
+                                                      const float* hr,
+                                                      const float* hi) noexcept
+    {
+      multiply_add(sr, si, xr, xi, hr, hi);
+    }
+
+    static constexpr util::Multiversioned<kernel> kernels = {
+      .generic = &multiply_add,
+      .avx2 = &multiply_add_avx2,
+      .avx512 = &multiply_add_avx512,
+    };
+
+    std::shared_ptr<const ConvolutionKernel<BlockSize>> kernel_;
+    util::RealFFT fft_;
+    /// The previous block of input followed by the block being collected
+    std::vector<float> input_;
+    /// Output of the last transform, of which the second half is being played back
+    std::vector<float> output_;
+    /// Frequency domain delay line: a ring of the spectra of the last `partitions` input frames
+    std::vector<float> delay_re_;
+    std::vector<float> delay_im_;
+    std::vector<float> sum_re_;
+    std::vector<float> sum_im_;
+    /// Samples collected in the current block
+    std::size_t fill_ = 0;
+    /// Slot of the newest spectrum in the delay line
+    std::size_t newest_ = 0;
+    std::size_t silent_ = infinite_tail;
+    /// Selected for the CPU when the evaluator is made
+    kernel multiply_add_;
+  };
+
+} // namespace eda
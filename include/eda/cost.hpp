@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+
+#include "eda/block.hpp"
+#include "eda/convolution.hpp"
+#include "eda/erased.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/mix.hpp"
+#include "eda/resampling.hpp"
+#include "eda/sample_player.hpp"
+#include "eda/stft.hpp"
+
+namespace eda {
+
+  // COST //////////////////////////////////////////////
+
+  /// Static estimate of the cost of evaluating a block.
+  ///
+  /// Operation counts are per frame at the rate of the block. They are upper bounds, since
+  /// control rate subgraphs, which are only evaluated once per buffer, are counted per frame.
+  struct Cost {
+    /// Additions and subtractions
+    double adds = 0;
+    /// Multiplications and divisions
+    double muls = 0;
+    /// Calls to user functions, like `fun` and `tanh`
+    double calls = 0;
+    /// Multiply-accumulates of FIR filters
+    double macs = 0;
+    /// Samples loaded or stored, like reading parameters or delay lines
+    double copies = 0;
+
+    /// Size of the evaluator, which holds all state that is touched every frame
+    std::size_t state_bytes = 0;
+    /// Size of the history buffers allocated by the evaluator. Delays count `default_delay_capacity`
+    /// samples, since the capacity of a `fixed_delay` is only known at runtime
+    std::size_t history_bytes = 0;
+    /// Peak stack usage of intermediate buffers while processing a buffer
+    std::size_t scratch_bytes = 0;
+
+    /// All operations, counting a multiply-accumulate as two
+    [[nodiscard]] constexpr double ops() const noexcept
+    {
+      return adds + muls + calls + 2 * macs + copies;
+    }
+
+    /// All memory used while processing
+    [[nodiscard]] constexpr std::size_t footprint() const noexcept
+    {
+      return state_bytes + history_bytes + scratch_bytes;
+    }
+
+    /// Operations of `a` and `b` evaluated one after the other. Scratch is not added, since
+    /// the two are not processed at the same time
+    friend constexpr Cost operator+(const Cost& a, const Cost& b) noexcept
+    {
+      return {
+        .adds = a.adds + b.adds,
+        .muls = a.muls + b.muls,
+        .calls = a.calls + b.calls,
+        .macs = a.macs + b.macs,
+        .copies = a.copies + b.copies,
+        .state_bytes = a.state_bytes + b.state_bytes,
+        .history_bytes = a.history_bytes + b.history_bytes,
+        .scratch_bytes = std::max(a.scratch_bytes, b.scratch_bytes),
+      };
+    }
+
+    /// Operations repeated `n` times per frame
+    friend constexpr Cost operator*(const Cost& a, double n) noexcept
+    {
+      Cost res = a;
+      res.adds *= n;
+      res.muls *= n;
+      res.calls *= n;
+      res.macs *= n;
+      res.copies *= n;
+      return res;
+    }
+  };
+
+  /// Cost of the operations of a block, and the history and scratch memory it uses.
+  ///
+  /// Specialize for new blocks. Leaves the `state_bytes` at zero, they are filled in by `cost`. There is no
+  /// default, so a block without a specialization is a compile error rather than counted as free.
+  template<AnyBlock T>
+  struct block_cost {
+    static_assert(sizeof(T) == 0, "Specialize block_cost for this block to estimate its cost");
+  };
+
+  namespace detail {
+    template<std::size_t Channels>
+    constexpr std::size_t scratch_bytes = sizeof(ScratchBuffer<Channels>);
+
+    template<AnyBlock... Ts>
+    constexpr Cost sum_costs() noexcept
+    {
+      return (block_cost<Ts>::value + ... + Cost{});
+    }
+
+    template<std::size_t Scratch>
+    constexpr Cost with_scratch(Cost c) noexcept
+    {
+      c.scratch_bytes += Scratch;
+      return c;
+    }
+
+    /// Operations of a real FFT of `N` samples: the `N / 4 * log2(N / 2)` butterflies of the half
+    /// size complex FFT, then untangling its `N / 2` bins, each a complex multiply and two additions
+    template<std::size_t N>
+    constexpr Cost fft_cost = {
+      .adds = (N / 4) * (std::bit_width(N / 2) - 1) * 6. + (N / 2) * 6.,
+      .muls = (N / 4) * (std::bit_width(N / 2) - 1) * 4. + (N / 2) * 4.,
+    };
+  } // namespace detail
+
+  /// Static cost of evaluating `Block`, see `Cost`. Usable in `static_assert` budgets.
+  template<AnyBlockRef Block>
+  constexpr Cost cost = [] {
+    Cost res = block_cost<std::remove_cvref_t<Block>>::value;
+    res.state_bytes = sizeof(evaluator<std::remove_cvref_t<Block>>);
+    return res;
+  }();
+
+  template<std::size_t N>
+  struct block_cost<Ident<N>> {
+    static constexpr Cost value = {};
+  };
+  template<std::size_t N>
+  struct block_cost<Cut<N>> {
+    static constexpr Cost value = {};
+  };
+  template<>
+  struct block_cost<Literal> {
+    static constexpr Cost value = {.copies = 1};
+  };
+  template<>
+  struct block_cost<Ref> {
+    static constexpr Cost value = {.copies = 1};
+  };
+  template<>
+  struct block_cost<Plus> {
+    static constexpr Cost value = {.adds = 1};
+  };
+  template<>
+  struct block_cost<Minus> {
+    static constexpr Cost value = {.adds = 1};
+  };
+  template<>
+  struct block_cost<Times> {
+    static constexpr Cost value = {.muls = 1};
+  };
+  template<>
+  struct block_cost<Divide> {
+    static constexpr Cost value = {.muls = 1};
+  };
+
+  template<std::size_t In, std::size_t Out, util::Callable<Frame<Out>(Frame<In>)> F>
+  struct block_cost<FunBlock<In, Out, F>> {
+    static constexpr Cost value = {.calls = 1};
+  };
+  template<std::size_t In, std::size_t Out, typename Func, typename... States>
+  struct block_cost<StatefulFunc<In, Out, Func, States...>> {
+    static constexpr Cost value = {.calls = 1};
+  };
+
+  template<std::size_t Samples, ASampleStorage Storage>
+  struct block_cost<Mem<Samples, Storage>> {
+    static constexpr bool external = Samples * sizeof(typename Storage::value_type) > 64;
+    static constexpr Cost value = {
+      .copies = Samples == 0 ? 0. : 2.,
+      .history_bytes = external ? Samples * sizeof(typename Storage::value_type) : 0,
+    };
+  };
+  template<std::size_t N>
+  struct block_cost<Compensation<N>> {
+    static constexpr Cost value = detail::sum_costs<Mem<N>>();
+  };
+  template<ASampleStorage Storage>
+  struct block_cost<BasicDelay<Storage>> {
+    static constexpr Cost value = {
+      .adds = 1,
+      .copies = 2,
+      .history_bytes = default_delay_capacity * sizeof(typename Storage::value_type),
+    };
+  };
+  template<std::size_t Taps, ASampleStorage Storage>
+  struct block_cost<MultiTap<Taps, Storage>> {
+    static constexpr Cost value = {
+      .adds = Taps,
+      .copies = 1 + Taps,
+      .history_bytes = default_delay_capacity * sizeof(typename Storage::value_type),
+    };
+  };
+  template<std::size_t N>
+  struct block_cost<FIRFilter<N>> {
+    static constexpr Cost value = {.macs = N, .copies = 1};
+  };
+
+  /// The virtual call into the erased subgraph, whose own cost is hidden
+  template<std::size_t In, std::size_t Out>
+  struct block_cost<Erased<In, Out>> {
+    static constexpr Cost value = {.calls = 1};
+  };
+
+  /// Every `BlockSize` frames, a forward and an inverse FFT of twice the size, and a complex multiply-add of
+  /// the spectra of each partition of the kernel. The number of partitions is only known at runtime,
+  /// so operations and history are counted for a single one
+  template<std::size_t BlockSize>
+  struct block_cost<Convolution<BlockSize>> {
+    static constexpr std::size_t bins = ConvolutionKernel<BlockSize>::bins;
+    static constexpr Cost value = [] {
+      const Cost per_block = {.macs = 4. * bins, .copies = static_cast<double>(BlockSize)};
+      auto res = (detail::fft_cost<2 * BlockSize> * 2 + per_block) * (1. / BlockSize);
+      res.copies += 2;
+      // Input and output frames, one partition of the delay line, the sum of the products, and the FFT
+      res.history_bytes = (6 * BlockSize + 4 * bins) * sizeof(float);
+      return res;
+    }();
+  };
+
+  /// Every `Hop` frames, a windowed forward FFT, a call to the spectral function, and an inverse FFT
+  /// overlap-added into the output
+  template<std::size_t FFTSize, std::size_t Hop, typename Func, typename... States>
+  struct block_cost<Stft<FFTSize, Hop, Func, States...>> {
+    static constexpr std::size_t bins = FFTSize / 2 + 1;
+    static constexpr Cost value = [] {
+      const Cost per_hop = {
+        .muls = FFTSize,
+        .calls = 1,
+        .macs = FFTSize,
+        .copies = 2. * (FFTSize + Hop),
+      };
+      auto res = (detail::fft_cost<FFTSize> * 2 + per_hop) * (1. / Hop);
+      res.copies += 2;
+      // Input, frame, overlap-add and FFT work buffers, the hop of output, and the spectrum
+      res.history_bytes = (4 * FFTSize + Hop + 2 * bins) * sizeof(float);
+      return res;
+    }();
+  };
+
+  /// Decodes a sample and interpolates from it to the next one. Buffers are decoded a chunk at a
+  /// time, into an array on the stack. The mapped samples are not counted
+  template<ASampleStorage Storage>
+  struct block_cost<SamplePlayer<Storage>> {
+    static constexpr Cost value = {
+      .adds = 3,
+      .muls = 1,
+      .copies = 2,
+      .scratch_bytes =
+        process_chunk * sizeof(double) + evaluator<SamplePlayer<Storage>>::max_span * sizeof(float),
+    };
+  };
+
+  /// Buffers of outputs are computed in scratch, since they may overwrite the inputs
+  template<std::size_t In, std::size_t Out>
+  struct block_cost<Mix<In, Out>> {
+    static constexpr Cost value = {.macs = In * Out, .scratch_bytes = detail::scratch_bytes<Out>};
+  };
+
+  template<AnyBlock Block, AnyBlock... Inputs>
+  struct block_cost<Partial<Block, Inputs...>> {
+    static constexpr Cost value = detail::sum_costs<Block, Inputs...>();
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_cost<Parallel<Lhs, Rhs>> {
+    /// Copies the input of `Rhs` when processing fully in-place
+    static constexpr Cost value = detail::with_scratch<detail::scratch_bytes<ins<Rhs>>>(detail::sum_costs<Lhs, Rhs>());
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_cost<Sequential<Lhs, Rhs>> {
+    static constexpr Cost value = detail::with_scratch<detail::scratch_bytes<outs<Lhs>>>(detail::sum_costs<Lhs, Rhs>());
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_cost<Split<Lhs, Rhs>> {
+    static constexpr Cost value =
+      detail::with_scratch<(std::same_as<Lhs, Ident<outs<Lhs>>> ? 0 : detail::scratch_bytes<outs<Lhs>>)>(
+        detail::sum_costs<Lhs, Rhs>());
+  };
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_cost<Merge<Lhs, Rhs>> {
+    static constexpr Cost value = [] {
+      auto res = detail::with_scratch<detail::scratch_bytes<outs<Lhs>> + detail::scratch_bytes<ins<Rhs>>>(
+        detail::sum_costs<Lhs, Rhs>());
+      res.adds += outs<Lhs> - ins<Rhs>;
+      return res;
+    }();
+  };
+  /// Affine loops are processed a chunk at a time, with the outputs of the operands, the coefficients and
+  /// the values before each frame in scratch, and when the coefficients vary, the fed back constants
+  template<AnyBlock Lhs, AnyBlock Rhs>
+  struct block_cost<Recursive<Lhs, Rhs>> {
+    static constexpr Cost value = [] {
+      auto res = detail::sum_costs<Lhs, Rhs>();
+      res.copies += outs<Rhs>;
+      if constexpr (is_affine_recurrence_v<Lhs, Rhs>) {
+        constexpr bool constant = is_linear_recurrence_v<Lhs, Rhs>;
+        res.scratch_bytes += detail::scratch_bytes<outs<Lhs>> + detail::scratch_bytes<1> +
+                             2 * sizeof(std::array<float, process_chunk>) + detail::scratch_bytes<constant ? 0 : 2> +
+                             detail::scratch_bytes<constant ? 0 : outs<Lhs>>;
+      }
+      return res;
+    }();
+  };
+  template<AnyBlock Block>
+  struct block_cost<Smooth<Block>> {
+    static constexpr Cost value = [] {
+      auto res = detail::sum_costs<Block>();
+      res.adds += outs<Block>;
+      return res;
+    }();
+  };
+  /// The inner block runs `N` times per frame, and the input is scaled to make up for zero stuffing
+  template<int N, AnyBlock Block>
+  struct block_cost<Resample<N, Block>> {
+    static constexpr Cost value = [] {
+      auto res = detail::sum_costs<Block>() * N;
+      res.muls += ins<Block>;
+      return res;
+    }();
+  };
+
+} // namespace eda
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "eda/arena.hpp"
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+
+namespace eda {
+
+  // ENGINE ////////////////////////////////////////////
+
+  /// Timing statistics for one engine instance
+  struct InstanceStats {
+    using duration = std::chrono::nanoseconds;
+    /// Processing time of the last tick
+    duration last = duration::zero();
+    /// Longest processing time seen
+    duration worst = duration::zero();
+    /// Number of ticks where the instance finished after its deadline
+    std::uint64_t deadline_misses = 0;
+    /// Number of ticks skipped because the instance was silent (see `Options::skip_silence`)
+    std::uint64_t skipped = 0;
+  };
+
+  /// Runs many independent evaluators of the same block across a pool of worker threads.
+  ///
+  /// Each instance keeps all its state, including delay line history, in its own contiguous
+  /// arena (see `ArenaEvaluator`), and their input and output buffers are stored in one
+  /// contiguous array. Each call to `tick` processes one buffer for every instance. Instances
+  /// are split into one contiguous range per thread, and threads that finish their own range
+  /// steal instances from the others. The thread calling `tick` takes part as worker 0.
+  template<AnyBlock Block>
+  struct Engine {
+    using clock = std::chrono::steady_clock;
+
+    struct Options {
+      /// Number of threads, including the one calling `tick`
+      std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+      /// Maximum number of frames per tick
+      std::size_t buffer_size = 128;
+      /// Pin each worker thread to its own core
+      bool pin_threads = true;
+      /// Skip evaluating instances that are quiescent and have silent input, see `process_or_skip`
+      bool skip_silence = false;
+    };
+
+    Engine(const Block& block, std::size_t instances) : Engine(block, instances, Options()) {}
+
+    Engine(const Block& block, std::size_t instances, Options options)
+      : options_(options),
+        instances_(instances, make_arena_evaluator(block)),
+        stats_(instances),
+        deadlines_(instances, InstanceStats::duration::max()),
+        inputs_(instances * ins<Block> * padded_size(options.buffer_size) / CacheLine::samples),
+        outputs_(instances * outs<Block> * padded_size(options.buffer_size) / CacheLine::samples),
+        workers_(std::max<std::size_t>(options.threads, 1))
+    {
+      const auto n_workers = workers_.size();
+      for (std::size_t w = 0; w < n_workers; w++) {
+        workers_[w].begin = instances * w / n_workers;
+        workers_[w].end = instances * (w + 1) / n_workers;
+      }
+      for (std::size_t w = 1; w < n_workers; w++) {
+        threads_.emplace_back([this, w] { worker_loop(w); });
+      }
+    }
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    ~Engine()
+    {
+      stop_.store(true, std::memory_order_relaxed);
+      generation_.fetch_add(1, std::memory_order_release);
+      generation_.notify_all();
+      for (auto& t : threads_) t.join();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return instances_.size();
+    }
+
+    [[nodiscard]] std::size_t threads() const noexcept
+    {
+      return workers_.size();
+    }
+
+    [[nodiscard]] std::size_t buffer_size() const noexcept
+    {
+      return options_.buffer_size;
+    }
+
+    evaluator<Block>& instance(std::size_t i) noexcept
+    {
+      return *instances_[i];
+    }
+
+    /// Input buffers of instance `i`. Fill before calling `tick`
+    [[nodiscard]] BufferView<ins<Block>> input(std::size_t i, std::size_t size) noexcept
+    {
+      return view<ins<Block>>(inputs_, i, size);
+    }
+
+    [[nodiscard]] BufferView<ins<Block>> input(std::size_t i) noexcept
+    {
+      return input(i, options_.buffer_size);
+    }
+
+    /// Output buffers of instance `i`. Valid after calling `tick`
+    [[nodiscard]] BufferView<outs<Block>> output(std::size_t i, std::size_t size) noexcept
+    {
+      return view<outs<Block>>(outputs_, i, size);
+    }
+
+    [[nodiscard]] BufferView<outs<Block>> output(std::size_t i) noexcept
+    {
+      return output(i, options_.buffer_size);
+    }
+
+    /// Set the time, relative to the start of a tick, within which instance `i` must be done.
+    void set_deadline(std::size_t i, InstanceStats::duration deadline) noexcept
+    {
+      deadlines_[i] = deadline;
+    }
+
+    [[nodiscard]] const InstanceStats& stats(std::size_t i) const noexcept
+    {
+      return stats_[i];
+    }
+
+    /// Process `n_samples` frames for all instances, and wait for them to finish.
+    ///
+    /// `n_samples` must not exceed the `buffer_size` the engine was created with. Asserted in debug
+    /// builds, and clamped otherwise.
+    void tick(std::size_t n_samples)
+    {
+      assert(n_samples <= options_.buffer_size);
+      n_samples_ = std::min(n_samples, options_.buffer_size);
+      tick_start_ = clock::now();
+      for (auto& w : workers_) w.next.store(w.begin, std::memory_order_relaxed);
+      busy_.store(workers_.size() - 1, std::memory_order_relaxed);
+      generation_.fetch_add(1, std::memory_order_release);
+      generation_.notify_all();
+
+      run_worker(0);
+
+      for (auto busy = busy_.load(std::memory_order_acquire); busy != 0; busy = busy_.load(std::memory_order_acquire)) {
+        busy_.wait(busy, std::memory_order_acquire);
+      }
+    }
+
+    void tick()
+    {
+      tick(options_.buffer_size);
+    }
+
+  private:
+    struct alignas(64) Worker {
+      std::size_t begin = 0;
+      std::size_t end = 0;
+      std::atomic<std::size_t> next = 0;
+    };
+
+    /// Every channel of every instance starts on its own cache line
+    template<std::size_t Channels>
+    BufferView<Channels> view(std::vector<CacheLine>& storage, std::size_t i, std::size_t size) noexcept
+    {
+      const auto stride = padded_size(options_.buffer_size);
+      std::array<float*, Channels> ptrs;
+      float* base = reinterpret_cast<float*>(storage.data()) + i * Channels * stride;
+      for (std::size_t c = 0; c < Channels; c++) ptrs[c] = base + c * stride;
+      return {ptrs, size};
+    }
+
+    void process_instance(std::size_t i)
+    {
+      auto& stats = stats_[i];
+      const auto start = clock::now();
+      if (options_.skip_silence) {
+        if (process_or_skip(instances_[i], input(i, n_samples_), output(i, n_samples_))) stats.skipped++;
+      } else {
+        process(instances_[i], input(i, n_samples_), output(i, n_samples_));
+      }
+      const auto end = clock::now();
+      stats.last = std::chrono::duration_cast<InstanceStats::duration>(end - start);
+      stats.worst = std::max(stats.worst, stats.last);
+      if (end - tick_start_ > deadlines_[i]) stats.deadline_misses++;
+    }
+
+    /// Claim an instance from worker `w`'s range, or return `end` if it is exhausted
+    std::size_t claim(Worker& w) noexcept
+    {
+      if (w.next.load(std::memory_order_relaxed) >= w.end) return w.end;
+      return std::min(w.next.fetch_add(1, std::memory_order_relaxed), w.end);
+    }
+
+    void run_worker(std::size_t self)
+    {
+      const auto n_workers = workers_.size();
+      for (std::size_t k = 0; k < n_workers; k++) {
+        auto& w = workers_[(self + k) % n_workers];
+        for (auto i = claim(w); i < w.end; i = claim(w)) {
+          process_instance(i);
+        }
+      }
+    }
+
+    void worker_loop(std::size_t self)
+    {
+      if (options_.pin_threads) pin_to_core(self);
+      std::uint64_t seen = 0;
+      while (true) {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (stop_.load(std::memory_order_relaxed)) return;
+        run_worker(self);
+        if (busy_.fetch_sub(1, std::memory_order_acq_rel) == 1) busy_.notify_all();
+      }
+    }
+
+    static void pin_to_core(std::size_t core) noexcept
+    {
+#ifdef __linux__
+      const auto n_cores = std::max(1u, std::thread::hardware_concurrency());
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(core % n_cores, &set);
+      // Pinning is best-effort, and may be disallowed in containers
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    Options options_;
+    std::vector<ArenaEvaluator<Block>> instances_;
+    std::vector<InstanceStats> stats_;
+    std::vector<InstanceStats::duration> deadlines_;
+    std::vector<CacheLine> inputs_;
+    std::vector<CacheLine> outputs_;
+    std::vector<Worker> workers_;
+    std::vector<std::thread> threads_;
+
+    std::size_t n_samples_ = 0;
+    clock::time_point tick_start_;
+    alignas(64) std::atomic<std::uint64_t> generation_ = 0;
+    alignas(64) std::atomic<std::size_t> busy_ = 0;
+    std::atomic<bool> stop_ = false;
+  };
+
+} // namespace eda
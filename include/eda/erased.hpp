@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "eda/block.hpp"
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+
+namespace eda {
+
+  // ERASED ////////////////////////////////////////////
+
+  /// Interface to the evaluator of a type erased block, see `Erased`.
+  template<std::size_t In, std::size_t Out>
+  struct ErasedEvaluator {
+    virtual ~ErasedEvaluator() = default;
+
+    virtual Frame<Out> eval(Frame<In> in) = 0;
+    virtual void begin_buffer(std::size_t n) = 0;
+    virtual void process(BufferView<In> in, BufferView<Out> out) = 0;
+    virtual void end_buffer() = 0;
+    virtual void reset() = 0;
+    [[nodiscard]] virtual bool quiescent() const = 0;
+    [[nodiscard]] virtual std::size_t tail_length() const = 0;
+    /// Copy of the evaluator, in its current state
+    [[nodiscard]] virtual std::unique_ptr<ErasedEvaluator> copy() const = 0;
+  };
+
+  /// Interface to a type erased block, which makes its evaluators. See `Erased`.
+  template<std::size_t In, std::size_t Out>
+  struct ErasedBlock {
+    virtual ~ErasedBlock() = default;
+
+    [[nodiscard]] virtual std::unique_ptr<ErasedEvaluator<In, Out>> make_evaluator() const = 0;
+  };
+
+  namespace detail {
+    template<AnyBlock Block>
+    struct ErasedEvaluatorImpl final : ErasedEvaluator<ins<Block>, outs<Block>> {
+      explicit ErasedEvaluatorImpl(const Block& b) : e_(b) {}
+
+      Frame<outs<Block>> eval(Frame<ins<Block>> in) override
+      {
+        return e_.eval(in);
+      }
+
+      void begin_buffer(std::size_t n) override
+      {
+        detail::begin_buffer(e_, n);
+      }
+
+      void process(BufferView<ins<Block>> in, BufferView<outs<Block>> out) override
+      {
+        detail::process_buffer(e_, in, out);
+      }
+
+      void end_buffer() override
+      {
+        detail::end_buffer(e_);
+      }
+
+      void reset() override
+      {
+        eda::reset(e_);
+      }
+
+      [[nodiscard]] bool quiescent() const override
+      {
+        return is_quiescent(e_);
+      }
+
+      [[nodiscard]] std::size_t tail_length() const override
+      {
+        return eda::tail_length(e_);
+      }
+
+      [[nodiscard]] std::unique_ptr<ErasedEvaluator<ins<Block>, outs<Block>>> copy() const override
+      {
+        return std::make_unique<ErasedEvaluatorImpl>(*this);
+      }
+
+    private:
+      evaluator<Block> e_;
+    };
+
+    template<AnyBlock Block>
+    struct ErasedBlockImpl final : ErasedBlock<ins<Block>, outs<Block>> {
+      explicit ErasedBlockImpl(Block b) : block_(std::move(b)) {}
+
+      [[nodiscard]] std::unique_ptr<ErasedEvaluator<ins<Block>, outs<Block>>> make_evaluator() const override
+      {
+        return std::make_unique<ErasedEvaluatorImpl<Block>>(block_);
+      }
+
+    private:
+      Block block_;
+    };
+  } // namespace detail
+
+  /// A block with `In` inputs and `Out` outputs, whose type does not depend on the subgraph it evaluates.
+  ///
+  /// The evaluator of the subgraph is only instantiated where `erased` is called, and is called through
+  /// one virtual call per buffer, or per frame when evaluated a frame at a time. Declaring a function
+  /// returning an `Erased` block in a header, and defining it in its own translation unit, keeps the
+  /// nested types of a large subgraph out of the graphs using it. They then recompile without it, and
+  /// its translation unit can be optimized even in debug builds.
+  ///
+  /// The latency of the subgraph is hidden from `latency`, so compensate it before erasing it. Its cost is
+  /// likewise hidden from `cost`, which only counts the virtual call.
+  template<std::size_t In, std::size_t Out>
+  struct Erased : BlockBase<Erased<In, Out>, In, Out> {
+    std::shared_ptr<const ErasedBlock<In, Out>> block;
+  };
+
+  template<AnyBlockRef Block>
+  Erased<ins<Block>, outs<Block>> erased(Block&& b)
+  {
+    return {{}, std::make_shared<const detail::ErasedBlockImpl<std::remove_cvref_t<Block>>>(FWD(b))};
+  }
+
+  template<std::size_t In, std::size_t Out>
+  struct evaluator<Erased<In, Out>> : EvaluatorBase<Erased<In, Out>> {
+    evaluator(const Erased<In, Out>& e) : impl_(e.block->make_evaluator()) {}
+
+    evaluator(const evaluator& rhs) : impl_(rhs.impl_->copy()) {}
+    evaluator(evaluator&&) noexcept = default;
+    evaluator& operator=(evaluator rhs) noexcept
+    {
+      std::swap(impl_, rhs.impl_);
+      return *this;
+    }
+
+    Frame<Out> eval(Frame<In> in)
+    {
+      return impl_->eval(in);
+    }
+
+    void begin_buffer(std::size_t n)
+    {
+      impl_->begin_buffer(n);
+    }
+
+    void process(BufferView<In> in, BufferView<Out> out)
+    {
+      impl_->process(in, out);
+    }
+
+    void end_buffer()
+    {
+      impl_->end_buffer();
+    }
+
+    void reset()
+    {
+      impl_->reset();
+    }
+
+    bool quiescent() const
+    {
+      return impl_->quiescent();
+    }
+
+    std::size_t tail_length() const
+    {
+      return impl_->tail_length();
+    }
+
+  private:
+    std::unique_ptr<ErasedEvaluator<In, Out>> impl_;
+  };
+
+} // namespace eda
@@ -1,9 +1,20 @@
 #pragma once
 
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <vector>
 
 #include "eda/block.hpp"
+#include "eda/buffer.hpp"
 #include "eda/frame.hpp"
+#include "eda/internal/cpu.hpp"
+
+#ifdef EDA_RT_CHECK
+#include "eda/internal/rt_check.hpp"
+#endif
 
 namespace eda {
 
@@ -34,13 +45,34 @@ namespace eda {
   template<AnyBlock T>
   struct EvaluatorBase {};
 
+  template<AnyBlock T>
+  struct ControlRateEvaluator;
+
+  template<typename T>
+  struct block_for<ControlRateEvaluator<T>> {
+    using type = T;
+  };
+
+  /// The evaluator used for an operand of a composition.
+  ///
+  /// Control rate subgraphs are wrapped in `ControlRateEvaluator`, except for
+  /// single `Literal` and `Ref` leaves, which are as cheap to evaluate as a cached value.
+  /// Subgraphs that contain a `Smooth` below their root are not held as a whole, so the
+  /// smoothed value keeps ramping, and their own control rate operands are wrapped instead.
+  template<AnyBlock T>
+  using operand_evaluator_t =
+    std::conditional_t<(AControlRateBlock<T> && !std::same_as<T, Literal> && !std::same_as<T, Ref> &&
+                        (!contains_smooth_v<T> || util::instance_of<T, Smooth>)),
+                       ControlRateEvaluator<T>,
+                       evaluator<T>>;
+
   namespace detail {
     template<typename T>
     struct add_evaluator {};
 
     template<typename... Ts>
     struct add_evaluator<std::tuple<Ts...>> {
-      using type = std::tuple<evaluator<Ts>...>;
+      using type = std::tuple<operand_evaluator_t<Ts>...>;
     };
 
     template<typename T>
@@ -68,6 +100,309 @@ namespace eda {
     return evaluator<std::remove_cvref_t<T>>(b);
   }
 
+  // BUFFER PROCESSING /////////////////////////////////
+
+  /// Call `f` with each operand evaluator of the evaluator `e`
+  template<typename E>
+  constexpr void for_each_operand(E& e, auto&& f)
+  {
+    if constexpr (requires { e.operands; }) {
+      std::apply([&](auto&... ops) { (f(ops), ...); }, e.operands);
+    }
+  }
+
+  namespace detail {
+    /// Latch the values of all control rate subgraphs of `e` for a buffer of `n` frames
+    template<typename E>
+    constexpr void begin_buffer(E& e, std::size_t n)
+    {
+      if constexpr (requires { e.begin_buffer(n); }) {
+        e.begin_buffer(n);
+      } else {
+        for_each_operand(e, [n](auto& op) { begin_buffer(op, n); });
+      }
+    }
+
+    /// Release the control rate values latched by `begin_buffer`
+    template<typename E>
+    constexpr void end_buffer(E& e)
+    {
+      if constexpr (requires { e.end_buffer(); }) {
+        e.end_buffer();
+      } else {
+        for_each_operand(e, [](auto& op) { end_buffer(op); });
+      }
+    }
+
+    /// Process a buffer within a buffer already started by `process`.
+    ///
+    /// Used by compositions to process their operands.
+    template<typename E>
+    constexpr void process_buffer(E& e, BufferView<ins<block_for_t<E>>> in, BufferView<outs<block_for_t<E>>> out)
+    {
+#ifdef EDA_RT_CHECK
+      const RtBlockScope scope(typeid(block_for_t<E>));
+#endif
+      if constexpr (requires { e.process(in, out); }) {
+        e.process(in, out);
+      } else {
+        const auto n = std::max(in.size(), out.size());
+        for (std::size_t i = 0; i < n; i++) {
+          out.set_frame(i, e.eval(in.frame(i)));
+        }
+      }
+    }
+  } // namespace detail
+
+  /// Process a buffer of frames with an evaluator.
+  ///
+  /// Uses the evaluator's own `process` member when it has one, and otherwise
+  /// calls `eval` once per frame. `in` and `out` must have the same size, and
+  /// may share channel buffers (in-place processing).
+  ///
+  /// Control rate subgraphs (see `AControlRateBlock`) are evaluated once, at the
+  /// start of the buffer.
+  template<typename E>
+  constexpr void process(E& e, BufferView<ins<block_for_t<E>>> in, BufferView<outs<block_for_t<E>>> out)
+  {
+    detail::begin_buffer(e, std::max(in.size(), out.size()));
+    detail::process_buffer(e, in, out);
+    detail::end_buffer(e);
+  }
+
+  // STATE /////////////////////////////////////////////
+
+  /// Storage for the bulky history of an evaluator, like the samples of a delay line.
+  ///
+  /// Owns its memory by default, but can be moved into external memory with `bind`,
+  /// which is how `ArenaEvaluator` lays out all history in one allocation. Copies always
+  /// own their memory, so copying an evaluator never shares history.
+  template<typename T>
+  struct HistoryBuffer {
+    HistoryBuffer() = default;
+    explicit HistoryBuffer(std::size_t size) : owned_(size), data_(owned_.data()), size_(size) {}
+
+    HistoryBuffer(const HistoryBuffer& rhs) : owned_(rhs.begin(), rhs.end()), data_(owned_.data()), size_(rhs.size_) {}
+
+    HistoryBuffer(HistoryBuffer&& rhs) noexcept
+      : owned_(std::move(rhs.owned_)), data_(std::exchange(rhs.data_, nullptr)), size_(std::exchange(rhs.size_, 0))
+    {}
+
+    HistoryBuffer& operator=(HistoryBuffer rhs) noexcept
+    {
+      std::swap(owned_, rhs.owned_);
+      std::swap(data_, rhs.data_);
+      std::swap(size_, rhs.size_);
+      return *this;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    /// Number of bytes needed to `bind` this buffer
+    [[nodiscard]] std::size_t bytes() const noexcept
+    {
+      return size_ * sizeof(T);
+    }
+
+    T* data() noexcept
+    {
+      return data_;
+    }
+    T* begin() noexcept
+    {
+      return data_;
+    }
+    T* end() noexcept
+    {
+      return data_ + size_;
+    }
+    const T* begin() const noexcept
+    {
+      return data_;
+    }
+    const T* end() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    T& operator[](std::size_t i) noexcept
+    {
+      return data_[i];
+    }
+
+    /// Grow to `size` elements, inserting zeros at the end. Moves bound buffers back to owned memory.
+    void resize(std::size_t size)
+    {
+      if (data_ != owned_.data()) owned_.assign(begin(), end());
+      owned_.resize(size);
+      data_ = owned_.data();
+      size_ = size;
+    }
+
+    void clear() noexcept
+    {
+      std::fill(begin(), end(), T{});
+    }
+
+    /// Move the contents to `memory`, which must hold at least `bytes()` bytes, and stay alive for
+    /// as long as this buffer.
+    void bind(std::byte* memory) noexcept
+    {
+      data_ = std::uninitialized_copy(begin(), end(), reinterpret_cast<T*>(memory)) - size_;
+      owned_ = {};
+    }
+
+  private:
+    std::vector<T> owned_;
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+
+  namespace detail {
+    template<typename E>
+    constexpr void reset(E& e, bool clear_history)
+    {
+      if constexpr (requires { e.reset(); }) e.reset();
+      if constexpr (requires { e.history(); }) {
+        if (clear_history) e.history().clear();
+      }
+      for_each_operand(e, [clear_history](auto& op) { reset(op, clear_history); });
+    }
+  } // namespace detail
+
+  /// Reset all state of an evaluator to its initial values, without allocating.
+  ///
+  /// Evaluators reset their own hot state in a `reset` member, and expose bulky history through a
+  /// `history` member returning a `HistoryBuffer`.
+  template<typename E>
+  constexpr void reset(E& e)
+  {
+    detail::reset(e, true);
+  }
+
+  /// Copy of `e` in its initial state.
+  ///
+  /// Cheaper than making a new evaluator from the block: derived state, like the repeated
+  /// kernel of a FIR filter, is copied rather than rebuilt.
+  template<typename E>
+  constexpr E clone(const E& e)
+  {
+    E res = e;
+    reset(res);
+    return res;
+  }
+
+  /// Call `f` with the `HistoryBuffer` of `e` and all its operands
+  template<typename E>
+  constexpr void for_each_history(E& e, auto&& f)
+  {
+    if constexpr (requires { e.history(); }) f(e.history());
+    for_each_operand(e, [&f](auto& op) { for_each_history(op, f); });
+  }
+
+  // QUIESCENCE ////////////////////////////////////////
+
+  /// Samples with a magnitude below this are considered silent. About -120 dBFS
+  constexpr float silence_threshold = 1e-6f;
+
+  /// Tail length of evaluators whose output may never decay, like feedback loops
+  constexpr std::size_t infinite_tail = std::numeric_limits<std::size_t>::max();
+
+  namespace detail {
+    constexpr std::size_t saturating_add(std::size_t a, std::size_t b) noexcept
+    {
+      return a > infinite_tail - b ? infinite_tail : a + b;
+    }
+
+    /// Number of consecutive silent samples at the end of `x`, continuing a run of `prev`
+    /// silent samples before it.
+    constexpr std::size_t count_silent(const float* x, std::size_t n, std::size_t prev) noexcept
+    {
+      for (std::size_t i = n; i > 0; i--) {
+        if (std::abs(x[i - 1]) > silence_threshold) return n - i;
+      }
+      return saturating_add(prev, n);
+    }
+  } // namespace detail
+
+  /// Whether all samples of `buffer` are silent
+  template<std::size_t Channels>
+  constexpr bool is_silent(const BufferView<Channels>& buffer) noexcept
+  {
+    for (std::size_t c = 0; c < Channels; c++) {
+      for (std::size_t i = 0; i < buffer.size(); i++) {
+        if (std::abs(buffer[c][i]) > silence_threshold) return false;
+      }
+    }
+    return true;
+  }
+
+  /// Whether all samples of `frame` are silent
+  template<std::size_t Channels>
+  constexpr bool is_silent(const Frame<Channels>& frame) noexcept
+  {
+    return std::ranges::all_of(frame, [](float x) { return std::abs(x) <= silence_threshold; });
+  }
+
+  /// Whether `e` has decayed: given silent input, it will keep producing the same output.
+  ///
+  /// Evaluators with state report it with a `quiescent` member. Stateless evaluators are
+  /// always quiescent, and other evaluators without a `quiescent` member never are.
+  template<typename E>
+  constexpr bool is_quiescent(const E& e)
+  {
+    if constexpr (requires { e.quiescent(); }) {
+      if (!e.quiescent()) return false;
+    } else if constexpr (!requires { e.operands; }) {
+      return is_stateless_v<block_for_t<E>>;
+    }
+    bool res = true;
+    for_each_operand(e, [&res](const auto& op) { res = res && is_quiescent(op); });
+    return res;
+  }
+
+  /// Upper bound on the number of frames it takes for the output of `e` to decay once its input is silent.
+  ///
+  /// Evaluators with state report their own with a `tail_length` member. Compositions add up the tails of their
+  /// operands, stateless evaluators have no tail, and others have an `infinite_tail`.
+  template<typename E>
+  constexpr std::size_t tail_length(const E& e)
+  {
+    if constexpr (requires { e.tail_length(); }) {
+      return e.tail_length();
+    } else if constexpr (requires { e.operands; }) {
+      std::size_t res = 0;
+      for_each_operand(e, [&res](const auto& op) { res = detail::saturating_add(res, tail_length(op)); });
+      return res;
+    } else {
+      return is_stateless_v<block_for_t<E>> ? 0 : infinite_tail;
+    }
+  }
+
+  /// Like `process`, but skips evaluation while `in` is silent and `e` is quiescent.
+  ///
+  /// When skipping, only the first frame is evaluated, and its output repeated for the
+  /// whole buffer. Returns whether the buffer was skipped.
+  template<typename E>
+  constexpr bool process_or_skip(E& e, BufferView<ins<block_for_t<E>>> in, BufferView<outs<block_for_t<E>>> out)
+  {
+    const auto n = std::max(in.size(), out.size());
+    detail::begin_buffer(e, n);
+    // Checked after `begin_buffer`, so smoothed parameters that start ramping are not skipped
+    const bool skip = n > 0 && is_silent(in) && is_quiescent(e);
+    if (skip) {
+      const auto first = e.eval(in.frame(0));
+      for (std::size_t c = 0; c < outs<block_for_t<E>>; c++) std::fill_n(out[c], n, first[c]);
+    } else {
+      detail::process_buffer(e, in, out);
+    }
+    detail::end_buffer(e);
+    return skip;
+  }
+
   // DYN EVALUATOR ///////////////////////////////////// $\label{code:dyn_eval}$
 
   template<std::size_t Ins, std::size_t Outs>
@@ -112,13 +447,18 @@ namespace eda {
 
   template<AnyBlock Block, AnyBlock... Inputs>
   struct evaluator<Partial<Block, Inputs...>> : EvaluatorBase<Partial<Block, Inputs...>> {
-    constexpr evaluator(const Partial<Block, Inputs...>& block) : block_(block.block), inputs_(block.inputs) {}
+    constexpr evaluator(const Partial<Block, Inputs...>& block)
+      : operands(std::tuple_cat(std::tuple<const Block&>(block.block), block.inputs))
+    {}
 
     constexpr Frame<outs<Partial<Block, Inputs...>>> eval(Frame<ins<Partial<Block, Inputs...>>> in)
     {
-      return block_.eval(eval_impl<>(in));
+      return std::get<0>(operands).eval(eval_impl<>(in));
     }
 
+    /// The evaluators of the block, followed by the evaluators of its inputs
+    std::tuple<evaluator<Block>, operand_evaluator_t<Inputs>...> operands;
+
   private:
     template<std::size_t Idx = 0>
     auto eval_impl(auto in)
@@ -126,15 +466,12 @@ namespace eda {
       if constexpr (Idx == sizeof...(Inputs)) {
         return in;
       } else {
-        auto& arg_block = std::get<Idx>(inputs_);
+        auto& arg_block = std::get<Idx + 1>(operands);
         constexpr auto arg_ins = ins<block_for_t<std::remove_cvref_t<decltype(arg_block)>>>;
         auto arg_res = arg_block.eval(slice<0, arg_ins>(in));
         return concat(arg_res, eval_impl<Idx + 1>(slice<arg_ins, -1>(in)));
       }
     }
-
-    evaluator<Block> block_;
-    std::tuple<evaluator<Inputs>...> inputs_;
   };
 
   // IDENT /////////////////////////////////////////////
@@ -170,6 +507,18 @@ namespace eda {
       auto l = std::get<0>(this->operands).eval(in);
       return std::get<1>(this->operands).eval(l);
     }
+
+    void process(BufferView<ins<Sequential<Lhs, Rhs>>> in, BufferView<outs<Sequential<Lhs, Rhs>>> out)
+    {
+      ScratchBuffer<outs<Lhs>> scratch;
+      const auto n = std::max(in.size(), out.size());
+      for (std::size_t i = 0; i < n; i += process_chunk) {
+        const auto len = std::min(process_chunk, n - i);
+        auto mid = scratch.view(len);
+        detail::process_buffer(std::get<0>(this->operands), in.subview(i, len), mid);
+        detail::process_buffer(std::get<1>(this->operands), mid, out.subview(i, len));
+      }
+    }
   };
 
   // PARALLEL ////////////////////////////////////////// $\label{code:comp_eval}$
@@ -184,22 +533,248 @@ namespace eda {
       auto r = std::get<1>(this->operands).eval(slice<ins<Lhs>, -1>(in));
       return concat(l, r);
     }
+
+    void process(BufferView<ins<Parallel<Lhs, Rhs>>> in, BufferView<outs<Parallel<Lhs, Rhs>>> out)
+    {
+      auto& [lhs, rhs] = this->operands;
+      auto l_in = slice<0, ins<Lhs>>(in);
+      auto r_in = slice<ins<Lhs>, -1>(in);
+      auto l_out = slice<0, outs<Lhs>>(out);
+      auto r_out = slice<outs<Lhs>, -1>(out);
+      // When processing in-place, run the operands in an order where neither
+      // overwrites the input of the other, and fall back to copying.
+      if (!overlaps(l_out, r_in)) {
+        detail::process_buffer(lhs, l_in, l_out);
+        detail::process_buffer(rhs, r_in, r_out);
+      } else if (!overlaps(r_out, l_in)) {
+        detail::process_buffer(rhs, r_in, r_out);
+        detail::process_buffer(lhs, l_in, l_out);
+      } else {
+        ScratchBuffer<ins<Rhs>> scratch;
+        const auto n = std::max(in.size(), out.size());
+        for (std::size_t i = 0; i < n; i += process_chunk) {
+          const auto len = std::min(process_chunk, n - i);
+          auto r_copy = scratch.view(len);
+          auto r_src = r_in.subview(i, len);
+          for (std::size_t c = 0; c < ins<Rhs>; c++) std::copy_n(r_src[c], len, r_copy[c]);
+          detail::process_buffer(lhs, l_in.subview(i, len), l_out.subview(i, len));
+          detail::process_buffer(rhs, r_copy, r_out.subview(i, len));
+        }
+      }
+    }
   };
 
   // RECURSIVE /////////////////////////////////////////
 
+  namespace detail {
+    /// Kernel of a feedback loop that is not solved a chunk at a time
+    struct NoKernel {};
+
+    using recurrence_kernel = float (*)(const float*, const float*, float, float*, std::size_t) noexcept;
+
+    /// Solve `m[k] = a[k] * m[k - 1] + b[k]` for the `len <= process_chunk` frames of a chunk.
+    ///
+    /// Writes the value before each frame to `prev`, and returns the value after the last one.
+    inline float solve_recurrence(const float* a, const float* b, float m, float* prev, std::size_t len) noexcept
+    {
+      for (std::size_t k = 0; k < len; k++) {
+        prev[k] = m;
+        m = a[k] * m + b[k];
+      }
+      return m;
+    }
+
+#if EDA_X86_DISPATCH
+    /// `solve_recurrence` 8 frames at a time, without relying on the compiler to vectorize it.
+    ///
+    /// Each group of 8 frames is first reduced to `m[j + r] = p[r] * m[j - 1] + s[r]` by a prefix scan
+    /// of the coefficients and inputs, which doesn't depend on `m`. Only the multiply-add with the value
+    /// carried from the previous group is then on the dependency chain, instead of one per frame.
+    EDA_TARGET_AVX2 inline float solve_recurrence_avx2(const float* a,
+                                                       const float* b,
+                                                       float m,
+                                                       float* prev,
+                                                       std::size_t len) noexcept
+    {
+      const __m256 ones = _mm256_set1_ps(1.f);
+      const __m256 zeros = _mm256_setzero_ps();
+      // Lane `r` takes lane `r - d`, and the first `d` lanes are then blended with the identity
+      const __m256i shift1 = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+      const __m256i shift2 = _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5);
+      const __m256i shift4 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3);
+      const __m256i last = _mm256_set1_epi32(7);
+      __m256 carry = _mm256_set1_ps(m);
+      for (std::size_t j = 0; j < len; j += 8) {
+        const auto n = std::min<std::size_t>(8, len - j);
+        __m256 p;
+        __m256 s;
+        if (n == 8) {
+          p = _mm256_loadu_ps(a + j);
+          s = _mm256_loadu_ps(b + j);
+        } else {
+          // Pad with frames that keep the value as it is
+          alignas(32) std::array<float, 8> pa;
+          alignas(32) std::array<float, 8> pb;
+          for (std::size_t r = 0; r < 8; r++) {
+            pa[r] = r < n ? a[j + r] : 1.f;
+            pb[r] = r < n ? b[j + r] : 0.f;
+          }
+          p = _mm256_load_ps(pa.data());
+          s = _mm256_load_ps(pb.data());
+        }
+        s = _mm256_fmadd_ps(p, _mm256_blend_ps(_mm256_permutevar8x32_ps(s, shift1), zeros, 0x01), s);
+        p = _mm256_mul_ps(p, _mm256_blend_ps(_mm256_permutevar8x32_ps(p, shift1), ones, 0x01));
+        s = _mm256_fmadd_ps(p, _mm256_blend_ps(_mm256_permutevar8x32_ps(s, shift2), zeros, 0x03), s);
+        p = _mm256_mul_ps(p, _mm256_blend_ps(_mm256_permutevar8x32_ps(p, shift2), ones, 0x03));
+        s = _mm256_fmadd_ps(p, _mm256_blend_ps(_mm256_permutevar8x32_ps(s, shift4), zeros, 0x0F), s);
+        p = _mm256_mul_ps(p, _mm256_blend_ps(_mm256_permutevar8x32_ps(p, shift4), ones, 0x0F));
+
+        const __m256 after = _mm256_fmadd_ps(p, carry, s);
+        const __m256 before = _mm256_blend_ps(_mm256_permutevar8x32_ps(after, shift1), carry, 0x01);
+        if (n == 8) {
+          _mm256_storeu_ps(prev + j, before);
+        } else {
+          alignas(32) std::array<float, 8> tail;
+          _mm256_store_ps(tail.data(), before);
+          std::copy_n(tail.begin(), n, prev + j);
+        }
+        carry = _mm256_permutevar8x32_ps(after, last);
+      }
+      return _mm256_cvtss_f32(carry);
+    }
+#endif
+
+    inline constexpr util::Multiversioned<recurrence_kernel> recurrence_kernels = {
+      .generic = solve_recurrence,
+#if EDA_X86_DISPATCH
+      .avx2 = solve_recurrence_avx2,
+#endif
+    };
+
+  } // namespace detail
+
   template<AnyBlock Lhs, AnyBlock Rhs>
   struct evaluator<Recursive<Lhs, Rhs>> : EvaluatorBase<Recursive<Lhs, Rhs>> {
-    constexpr evaluator(const Recursive<Lhs, Rhs>& block) : EvaluatorBase<Recursive<Lhs, Rhs>>(block) {}
+    constexpr evaluator(const Recursive<Lhs, Rhs>& block) : EvaluatorBase<Recursive<Lhs, Rhs>>(block)
+    {
+      if constexpr (is_affine_recurrence_v<Lhs, Rhs>) {
+        if (!std::is_constant_evaluated()) solve_ = detail::recurrence_kernels.select();
+      }
+    }
+
     constexpr Frame<outs<Recursive<Lhs, Rhs>>> eval(Frame<ins<Recursive<Lhs, Rhs>>> in)
     {
+      const bool was_silent = is_silent(memory_);
       auto l_out = std::get<0>(this->operands).eval(concat(memory_, in));
       memory_ = std::get<1>(this->operands).eval(slice<0, ins<Rhs>>(l_out));
+      settled_ = was_silent && is_silent(memory_) && is_silent(in);
       return l_out;
     }
 
+    /// Solve an affine recurrence (see `is_affine_recurrence_v`) a chunk at a time.
+    ///
+    /// The fed back value evolves as `m[n] = a[n] * m[n - 1] + b[n]`, and each output as
+    /// `y[n] = g[n] * m[n - 1] + z[n]`. `b` and `z` are the outputs of the operands with 0 fed back.
+    /// When the coefficients only depend on parameters (see `is_linear_recurrence_v`), `a` and `g` are
+    /// found once per buffer from a single frame, and the operands are evaluated frame by frame in a
+    /// loop where no frame waits for the previous one. Otherwise, the operands are processed through
+    /// the buffer path, once with 0 and once with 1 fed back. The recurrence itself is then solved 8
+    /// frames at a time by the kernel selected for the CPU.
+    EDA_FLATTEN void process(BufferView<ins<Recursive<Lhs, Rhs>>> in, BufferView<outs<Recursive<Lhs, Rhs>>> out) //
+      requires is_affine_recurrence_v<Lhs, Rhs>
+    {
+      constexpr bool constant = is_linear_recurrence_v<Lhs, Rhs>;
+      auto& [lhs, rhs] = this->operands;
+      const auto n = std::max(in.size(), out.size());
+      // The coefficients change within the buffer while a control rate value is ramping
+      if (!is_quiescent(lhs) || !is_quiescent(rhs)) {
+        for (std::size_t i = 0; i < n; i++) out.set_frame(i, eval(in.frame(i)));
+        return;
+      }
+      ScratchBuffer<outs<Lhs>> l_scratch;
+      ScratchBuffer<1> b_scratch;
+      alignas(64) std::array<float, process_chunk> a;
+      alignas(64) std::array<float, process_chunk> prev;
+      // Fed back values, and the outputs with 1 fed back, for coefficients that vary
+      ScratchBuffer<constant ? 0 : 2> feedback;
+      ScratchBuffer<constant ? 0 : outs<Lhs>> g_scratch;
+      Frame<outs<Lhs>> gains;
+      if constexpr (constant) {
+        Frame<ins<Lhs>> probe = {};
+        const auto l0 = lhs.eval(probe);
+        probe[0] = 1;
+        const auto l1 = lhs.eval(probe);
+        for (std::size_t c = 0; c < outs<Lhs>; c++) gains[c] = l1[c] - l0[c];
+        a.fill(rhs.eval(slice<0, ins<Rhs>>(l1))[0] - rhs.eval(slice<0, ins<Rhs>>(l0))[0]);
+      } else {
+        std::fill_n(feedback.view()[0], process_chunk, 0.f);
+        std::fill_n(feedback.view()[1], process_chunk, 1.f);
+      }
+
+      for (std::size_t i = 0; i < n; i += process_chunk) {
+        const auto len = std::min(process_chunk, n - i);
+        const auto l_out = l_scratch.view(len);
+        const auto b = b_scratch.view(len);
+        const auto chunk_in = in.subview(i, len);
+        if constexpr (constant) {
+          for (std::size_t k = 0; k < len; k++) {
+            const auto l = lhs.eval(concat(Frame<1>{}, chunk_in.frame(k)));
+            b[0][k] = rhs.eval(slice<0, ins<Rhs>>(l))[0];
+            l_out.set_frame(k, l);
+          }
+        } else {
+          // `g` and `a` first hold the outputs with 1 fed back
+          const auto g = g_scratch.view(len);
+          detail::process_buffer(lhs, concat(slice<1, 2>(feedback.view(len)), chunk_in), g);
+          detail::process_buffer(rhs, slice<0, ins<Rhs>>(g), BufferView<1>({a.data()}, len));
+          detail::process_buffer(lhs, concat(slice<0, 1>(feedback.view(len)), chunk_in), l_out);
+          detail::process_buffer(rhs, slice<0, ins<Rhs>>(l_out), b);
+          for (std::size_t k = 0; k < len; k++) a[k] -= b[0][k];
+          for (std::size_t c = 0; c < outs<Lhs>; c++) {
+            for (std::size_t k = 0; k < len; k++) g[c][k] -= l_out[c][k];
+          }
+        }
+        memory_[0] = solve_(a.data(), b[0], memory_[0], prev.data(), len);
+        settled_ = is_silent(Frame(prev[len - 1])) && is_silent(memory_) && is_silent(in.frame(i + len - 1));
+
+        const auto chunk_out = out.subview(i, len);
+        for (std::size_t c = 0; c < outs<Lhs>; c++) {
+          if constexpr (constant) {
+            for (std::size_t k = 0; k < len; k++) chunk_out[c][k] = l_out[c][k] + gains[c] * prev[k];
+          } else {
+            const auto g = g_scratch.view(len);
+            for (std::size_t k = 0; k < len; k++) chunk_out[c][k] = l_out[c][k] + g[c][k] * prev[k];
+          }
+        }
+      }
+    }
+
+    constexpr void reset()
+    {
+      memory_ = {};
+      settled_ = rests_at_zero_v<Lhs, Rhs>;
+    }
+
+    /// Once the fed back signal has decayed below `silence_threshold`, and the last frame,
+    /// given silent input, kept it there
+    constexpr bool quiescent() const
+    {
+      return settled_;
+    }
+
+    constexpr std::size_t tail_length() const
+    {
+      return infinite_tail;
+    }
+
   private:
     Frame<outs<Rhs>> memory_;
+    /// Whether the last frame had silent input, and the fed back signal was silent before and after it.
+    /// Starts out set when the loop is known to rest there, see `rests_at_zero_v`
+    bool settled_ = rests_at_zero_v<Lhs, Rhs>;
+    /// Solves the recurrence in `process`, selected for the CPU when the evaluator is made
+    [[no_unique_address]] std::conditional_t<is_affine_recurrence_v<Lhs, Rhs>, detail::recurrence_kernel, detail::NoKernel>
+      solve_ = {};
   };
 
   // Split /////////////////////////////////////////////
@@ -211,12 +786,43 @@ namespace eda {
     constexpr Frame<outs<Split<Lhs, Rhs>>> eval(Frame<ins<Split<Lhs, Rhs>>> in)
     {
       auto l = std::get<0>(this->operands).eval(in);
+      // Broadcast by copying whole frames, so there is no per-channel modulo
       Frame<ins<Rhs>> rhs_in;
-      for (std::size_t i = 0; i < rhs_in.channels(); i++) {
-        rhs_in[i] = l[i % l.channels()];
+      for (std::size_t r = 0; r < repeats; r++) {
+        std::copy_n(l.begin(), outs<Lhs>, rhs_in.begin() + r * outs<Lhs>);
       }
       return std::get<1>(this->operands).eval(rhs_in);
     }
+
+    /// Broadcasts channels by repeating channel pointers, without copying any samples
+    void process(BufferView<ins<Split<Lhs, Rhs>>> in, BufferView<outs<Split<Lhs, Rhs>>> out)
+    {
+      auto& [lhs, rhs] = this->operands;
+      if constexpr (std::same_as<Lhs, Ident<outs<Lhs>>>) {
+        detail::process_buffer(rhs, broadcast(in), out);
+      } else {
+        ScratchBuffer<outs<Lhs>> scratch;
+        const auto n = std::max(in.size(), out.size());
+        for (std::size_t i = 0; i < n; i += process_chunk) {
+          const auto len = std::min(process_chunk, n - i);
+          auto l_out = scratch.view(len);
+          detail::process_buffer(lhs, in.subview(i, len), l_out);
+          detail::process_buffer(rhs, broadcast(l_out), out.subview(i, len));
+        }
+      }
+    }
+
+  private:
+    static constexpr std::size_t repeats = ins<Rhs> / outs<Lhs>;
+
+    static BufferView<ins<Rhs>> broadcast(BufferView<outs<Lhs>> l)
+    {
+      std::array<float*, ins<Rhs>> ptrs;
+      for (std::size_t r = 0; r < repeats; r++) {
+        std::copy_n(l.channel_ptrs().begin(), outs<Lhs>, ptrs.begin() + r * outs<Lhs>);
+      }
+      return {ptrs, l.size()};
+    }
   };
 
   // MERGE /////////////////////////////////////////////
@@ -228,12 +834,42 @@ namespace eda {
     constexpr Frame<outs<Merge<Lhs, Rhs>>> eval(Frame<ins<Merge<Lhs, Rhs>>> in)
     {
       auto lhs_out = std::get<0>(this->operands).eval(in);
+      // Accumulate whole frames, so there is no per-channel modulo
       Frame<ins<Rhs>> rhs_in;
-      for (std::size_t i = 0; i < lhs_out.channels(); i++) {
-        rhs_in[i % rhs_in.channels()] += lhs_out[i];
+      for (std::size_t r = 0; r < repeats; r++) {
+        for (std::size_t c = 0; c < ins<Rhs>; c++) {
+          rhs_in[c] += lhs_out[r * ins<Rhs> + c];
+        }
       }
       return std::get<1>(this->operands).eval(rhs_in);
     }
+
+    /// Sums each group of channels as contiguous runs of samples
+    void process(BufferView<ins<Merge<Lhs, Rhs>>> in, BufferView<outs<Merge<Lhs, Rhs>>> out)
+    {
+      auto& [lhs, rhs] = this->operands;
+      ScratchBuffer<outs<Lhs>> l_scratch;
+      ScratchBuffer<ins<Rhs>> r_scratch;
+      const auto n = std::max(in.size(), out.size());
+      for (std::size_t i = 0; i < n; i += process_chunk) {
+        const auto len = std::min(process_chunk, n - i);
+        auto l_out = l_scratch.view(len);
+        auto r_in = r_scratch.view(len);
+        detail::process_buffer(lhs, in.subview(i, len), l_out);
+        for (std::size_t c = 0; c < ins<Rhs>; c++) {
+          float* dst = r_in[c];
+          std::copy_n(l_out[c], len, dst);
+          for (std::size_t r = 1; r < repeats; r++) {
+            const float* src = l_out[r * ins<Rhs> + c];
+            for (std::size_t j = 0; j < len; j++) dst[j] += src[j];
+          }
+        }
+        detail::process_buffer(rhs, r_in, out.subview(i, len));
+      }
+    }
+
+  private:
+    static constexpr std::size_t repeats = outs<Lhs> / ins<Rhs>;
   };
 
   // ARITHMETIC ////////////////////////////////////////
@@ -285,65 +921,274 @@ namespace eda {
       return res;
     }
 
+    constexpr void reset()
+    {
+      memory_ = {};
+    }
+
+    constexpr bool quiescent() const
+    {
+      return std::abs(memory_[0]) <= silence_threshold;
+    }
+
+    constexpr std::size_t tail_length() const
+    {
+      return 1;
+    }
+
     Frame<1> memory_;
   };
 
-  template<>
-  struct evaluator<Mem<0>> : EvaluatorBase<Mem<0>> {
-    constexpr evaluator(const Mem<0>&) {}
+  template<ASampleStorage Storage>
+  struct evaluator<Mem<0, Storage>> : EvaluatorBase<Mem<0, Storage>> {
+    constexpr evaluator(const Mem<0, Storage>&) {}
     constexpr Frame<1> eval(Frame<1> in)
     {
       return in;
     }
   };
 
-  template<std::size_t Samples>
-  struct evaluator<Mem<Samples>> : EvaluatorBase<Mem<Samples>> {
-    constexpr evaluator(const Mem<Samples>&) {}
+  template<std::size_t Samples, ASampleStorage Storage>
+  struct evaluator<Mem<Samples, Storage>> : EvaluatorBase<Mem<Samples, Storage>> {
+    constexpr evaluator(const Mem<Samples, Storage>&) {}
     constexpr Frame<1> eval(Frame<1> in)
     {
-      float res = memory_[index_];
-      memory_[index_] = in;
+      float res = Storage::decode(memory_[index_]);
+      memory_[index_] = Storage::encode(in);
       index_++;
       index_ %= Samples;
+      silent_ = std::abs(in[0]) <= silence_threshold ? detail::saturating_add(silent_, 1) : 0;
       return res;
     }
 
-    std::array<float, Samples> memory_ = {};
+    /// Copies contiguous runs of the ring buffer, converting a whole run at a time
+    void process(BufferView<1> in, BufferView<1> out)
+    {
+      std::array<float, process_chunk> tmp;
+      for (std::size_t i = 0; i < in.size();) {
+        const auto n = std::min({in.size() - i, process_chunk, Samples - static_cast<std::size_t>(index_)});
+        // Decode first, so `in` and `out` may be the same buffer
+        codec_.decode(memory_.data() + index_, tmp.data(), n);
+        codec_.encode(in[0] + i, memory_.data() + index_, n);
+        silent_ = detail::count_silent(in[0] + i, n, silent_);
+        std::copy_n(tmp.data(), n, out[0] + i);
+        index_ = (index_ + n) % Samples;
+        i += n;
+      }
+    }
+
+    constexpr void reset()
+    {
+      if constexpr (!external_history) std::ranges::fill(memory_, value_type{});
+      index_ = 0;
+      silent_ = infinite_tail;
+    }
+
+    /// Once the last `Samples` inputs were silent
+    constexpr bool quiescent() const
+    {
+      return silent_ >= Samples;
+    }
+
+    constexpr std::size_t tail_length() const
+    {
+      return Samples;
+    }
+
+    auto& history() noexcept requires(Samples * sizeof(typename Storage::value_type) > 64)
+    {
+      return memory_;
+    }
+
+  private:
+    using value_type = typename Storage::value_type;
+    /// Histories larger than a cache line are kept out of the hot state. Matches `history`
+    static constexpr bool external_history = Samples * sizeof(value_type) > 64;
+
+    std::conditional_t<external_history, HistoryBuffer<value_type>, std::array<value_type, Samples>> memory_ =
+      make_memory();
     std::ptrdiff_t index_ = 0;
+    /// Number of consecutive silent inputs
+    std::size_t silent_ = infinite_tail;
+    [[no_unique_address]] storage::Codec<Storage> codec_;
+
+    static constexpr auto make_memory()
+    {
+      if constexpr (external_history) {
+        return HistoryBuffer<value_type>(Samples);
+      } else {
+        return std::array<value_type, Samples>{};
+      }
+    }
+  };
+
+  template<std::size_t N>
+  struct evaluator<Compensation<N>> : EvaluatorBase<Compensation<N>> {
+    constexpr evaluator(const Compensation<N>& c) : EvaluatorBase<Compensation<N>>(c) {}
+
+    constexpr Frame<1> eval(Frame<1> in)
+    {
+      return std::get<0>(this->operands).eval(in);
+    }
+
+    void process(BufferView<1> in, BufferView<1> out)
+    {
+      detail::process_buffer(std::get<0>(this->operands), in, out);
+    }
   };
 
   // DELAY /////////////////////////////////////////////
 
   /// Evaluator for variable sized delay.
   ///
-  /// Memory is implemented as a `std::vector`, and never shrinks
-  template<>
-  struct evaluator<Delay> : EvaluatorBase<Delay> {
-    evaluator(const Delay&) {}
-    Frame<outs<Delay>> eval(Frame<ins<Delay>> in)
-    {
-      auto delay = static_cast<int>(in[0]);
-      if (auto old_size = memory_.size(); old_size < delay) {
-        memory_.resize(delay);
-        auto src = memory_.begin() + old_size - 1;
-        auto dst = memory_.begin() + delay - 1;
-        auto n = old_size - index_;
-        for (int i = 0; i < n; i++, src--, dst--) {
-          *dst = *src;
-          *src = 0;
-        }
-      }
-      float res = memory_[(memory_.size() + index_ - delay) % memory_.size()];
-      memory_[index_] = in[1];
+  /// Memory for the capacity of the delay, or `default_delay_capacity` samples, is allocated up
+  /// front, and longer delays are clamped, so evaluating never allocates.
+  template<ASampleStorage Storage>
+  struct evaluator<BasicDelay<Storage>> : EvaluatorBase<BasicDelay<Storage>> {
+    evaluator(const BasicDelay<Storage>& d) : memory_(d.capacity > 0 ? d.capacity : default_delay_capacity) {}
+
+    Frame<1> eval(Frame<2> in)
+    {
+      auto delay = clamp(static_cast<int>(in[0]));
+      float res = Storage::decode(memory_[(memory_.size() + index_ - delay) % memory_.size()]);
+      memory_[index_] = Storage::encode(in[1]);
       ++index_;
       index_ %= static_cast<std::ptrdiff_t>(memory_.size());
+      silent_ = std::abs(in[1]) <= silence_threshold ? detail::saturating_add(silent_, 1) : 0;
+      return res;
+    }
+
+    /// Converts samples a chunk at a time
+    void process(BufferView<2> in, BufferView<1> out)
+    {
+      std::array<value_type, process_chunk> encoded;
+      std::array<value_type, process_chunk> read;
+      for (std::size_t i = 0; i < in.size(); i += process_chunk) {
+        const auto n = std::min(process_chunk, in.size() - i);
+        const float* delays = in[0] + i;
+        codec_.encode(in[1] + i, encoded.data(), n);
+        const auto size = static_cast<std::ptrdiff_t>(memory_.size());
+        for (std::size_t j = 0; j < n; j++) {
+          read[j] = memory_[(size + index_ - clamp(static_cast<int>(delays[j]))) % size];
+          memory_[index_] = encoded[j];
+          if (++index_ == size) index_ = 0;
+        }
+        silent_ = detail::count_silent(in[1] + i, n, silent_);
+        codec_.decode(read.data(), out[0] + i, n);
+      }
+    }
+
+    void reset() noexcept
+    {
+      index_ = 0;
+      silent_ = infinite_tail;
+    }
+
+    /// Once the whole history is silent
+    bool quiescent() const noexcept
+    {
+      return silent_ >= memory_.size();
+    }
+
+    std::size_t tail_length() const noexcept
+    {
+      return memory_.size();
+    }
+
+    auto& history() noexcept
+    {
+      return memory_;
+    }
+
+  private:
+    using value_type = typename Storage::value_type;
+
+    int clamp(int delay) const noexcept
+    {
+      return std::min(delay, static_cast<int>(memory_.size()));
+    }
+
+    HistoryBuffer<value_type> memory_;
+    std::ptrdiff_t index_ = 0;
+    std::size_t silent_ = infinite_tail;
+    [[no_unique_address]] storage::Codec<Storage> codec_;
+  };
+
+  // MULTITAP //////////////////////////////////////////
+
+  template<std::size_t Taps, ASampleStorage Storage>
+  struct evaluator<MultiTap<Taps, Storage>> : EvaluatorBase<MultiTap<Taps, Storage>> {
+    evaluator(const MultiTap<Taps, Storage>& d) : memory_(d.capacity > 0 ? d.capacity : default_delay_capacity)
+    {}
+
+    Frame<Taps> eval(Frame<Taps + 1> in)
+    {
+      const auto size = static_cast<std::ptrdiff_t>(memory_.size());
+      Frame<Taps> res;
+      for (std::size_t t = 0; t < Taps; t++) {
+        res[t] = Storage::decode(memory_[(size + index_ - clamp(static_cast<int>(in[t]))) % size]);
+      }
+      memory_[index_] = Storage::encode(in[Taps]);
+      if (++index_ == size) index_ = 0;
+      silent_ = std::abs(in[Taps]) <= silence_threshold ? detail::saturating_add(silent_, 1) : 0;
       return res;
     }
 
+    /// Reads all taps of a chunk in one pass over the history, writing each sample once
+    void process(BufferView<Taps + 1> in, BufferView<Taps> out)
+    {
+      std::array<value_type, process_chunk> encoded;
+      std::array<std::array<value_type, process_chunk>, Taps> read;
+      for (std::size_t i = 0; i < in.size(); i += process_chunk) {
+        const auto n = std::min(process_chunk, in.size() - i);
+        codec_.encode(in[Taps] + i, encoded.data(), n);
+        const auto size = static_cast<std::ptrdiff_t>(memory_.size());
+        for (std::size_t j = 0; j < n; j++) {
+          for (std::size_t t = 0; t < Taps; t++) {
+            read[t][j] = memory_[(size + index_ - clamp(static_cast<int>(in[t][i + j]))) % size];
+          }
+          memory_[index_] = encoded[j];
+          if (++index_ == size) index_ = 0;
+        }
+        silent_ = detail::count_silent(in[Taps] + i, n, silent_);
+        for (std::size_t t = 0; t < Taps; t++) codec_.decode(read[t].data(), out[t] + i, n);
+      }
+    }
+
+    void reset() noexcept
+    {
+      index_ = 0;
+      silent_ = infinite_tail;
+    }
+
+    /// Once the whole history is silent
+    bool quiescent() const noexcept
+    {
+      return silent_ >= memory_.size();
+    }
+
+    std::size_t tail_length() const noexcept
+    {
+      return memory_.size();
+    }
+
+    auto& history() noexcept
+    {
+      return memory_;
+    }
+
   private:
-    std::vector<float> memory_;
+    using value_type = typename Storage::value_type;
+
+    int clamp(int delay) const noexcept
+    {
+      return std::min(delay, static_cast<int>(memory_.size()));
+    }
+
+    HistoryBuffer<value_type> memory_;
     std::ptrdiff_t index_ = 0;
+    std::size_t silent_ = infinite_tail;
+    [[no_unique_address]] storage::Codec<Storage> codec_;
   };
 
   // REF ///////////////////////////////////////////////
@@ -360,6 +1205,83 @@ namespace eda {
     Ref ref_;
   };
 
+  // CONTROL RATE //////////////////////////////////////
+
+  /// Evaluator wrapping a control rate subgraph of a larger graph.
+  ///
+  /// While processing a buffer, the subgraph is evaluated once in `begin_buffer`,
+  /// and its value is reused for every frame. Otherwise the subgraph is evaluated
+  /// every time, so evaluating one frame at a time sees parameter changes immediately.
+  template<AnyBlock Block>
+  struct ControlRateEvaluator {
+    constexpr ControlRateEvaluator(const Block& b) : inner_(b) {}
+
+    constexpr Frame<outs<Block>> eval(Frame<0>)
+    {
+      if (!held_) return inner_.eval({});
+      if (remaining_ > 0) {
+        remaining_--;
+        for (std::size_t c = 0; c < outs<Block>; c++) value_[c] += step_[c];
+      }
+      return value_;
+    }
+
+    constexpr void begin_buffer(std::size_t n)
+    {
+      auto target = inner_.eval({});
+      if constexpr (util::instance_of<Block, Smooth>) {
+        if (initialized_ && n > 0) {
+          for (std::size_t c = 0; c < outs<Block>; c++) step_[c] = (target[c] - value_[c]) / n;
+          remaining_ = n;
+          held_ = true;
+          return;
+        }
+      }
+      value_ = target;
+      remaining_ = 0;
+      initialized_ = true;
+      held_ = true;
+    }
+
+    constexpr void reset()
+    {
+      remaining_ = 0;
+      held_ = false;
+      initialized_ = false;
+    }
+
+    /// Unless a smoothed value is ramping
+    constexpr bool quiescent() const
+    {
+      return remaining_ == 0 || std::ranges::all_of(step_, [](float s) { return s == 0; });
+    }
+
+    constexpr void end_buffer()
+    {
+      for (std::size_t c = 0; c < outs<Block>; c++) value_[c] += step_[c] * remaining_;
+      remaining_ = 0;
+      held_ = false;
+    }
+
+  private:
+    evaluator<Block> inner_;
+    Frame<outs<Block>> value_;
+    Frame<outs<Block>> step_;
+    std::size_t remaining_ = 0;
+    bool held_ = false;
+    bool initialized_ = false;
+  };
+
+  template<AnyBlock Block>
+  struct evaluator<Smooth<Block>> : EvaluatorBase<Smooth<Block>> {
+    constexpr evaluator(const Smooth<Block>& s) : EvaluatorBase<Smooth<Block>>(s) {}
+
+    constexpr Frame<outs<Block>> eval(Frame<0> in)
+    {
+      return std::get<0>(this->operands).eval(in);
+    }
+  };
+
   // FUNCTION ////////////////////////////////////////// $\label{code:extra_eval}$
 
   /// Adapt a function to a block
@@ -379,15 +1301,23 @@ namespace eda {
 
   template<std::size_t In, std::size_t Out, typename Func, typename... States>
   struct evaluator<StatefulFunc<In, Out, Func, States...>> : EvaluatorBase<StatefulFunc<In, Out, Func, States...>> {
-    constexpr evaluator(const StatefulFunc<In, Out, Func, States...>& f) noexcept : func_(f.func), states_(f.states) {}
+    constexpr evaluator(const StatefulFunc<In, Out, Func, States...>& f) noexcept
+      : func_(f.func), initial_states_(f.states), states_(f.states)
+    {}
 
     Frame<Out> eval(Frame<In> in)
     {
       return std::apply([&](States&... s) { return func_(in, s...); }, states_);
     }
 
+    constexpr void reset()
+    {
+      states_ = initial_states_;
+    }
+
   private:
     Func func_;
+    std::tuple<States...> initial_states_;
     std::tuple<States...> states_;
   };
 
@@ -406,14 +1336,34 @@ namespace eda {
       if (t == N) t = 0;
       t++;
       z[N - t] = in;
+      silent_ = std::abs(in[0]) <= silence_threshold ? detail::saturating_add(silent_, 1) : 0;
       // By repeating the kernel, there is always a contiguous range to
       // run the inner product on
       auto start = kernel.begin() + t;
       return std::inner_product(start, start + N, z.begin(), 0.f);
     }
 
+    constexpr void reset()
+    {
+      t = 0;
+      z = {0};
+      silent_ = infinite_tail;
+    }
+
+    /// Once all taps hold silent samples
+    constexpr bool quiescent() const
+    {
+      return silent_ >= N;
+    }
+
+    constexpr std::size_t tail_length() const
+    {
+      return N;
+    }
+
   private:
     std::size_t t = 0;
+    std::size_t silent_ = infinite_tail;
     std::array<float, N> z = {0};
     /// Kernel is repeated
     std::array<float, 2 * N> kernel;
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "eda/block.hpp"
+#include "eda/internal/constexpr_math.hpp"
+
+/// Compile time design of linear phase FIR kernels.
+///
+/// Frequencies are given as a fraction of the sample rate, so `0.5` is the Nyquist frequency,
+/// and `0.25` the cutoff of a halfband filter.
+namespace eda::design {
+
+  // WINDOWS ///////////////////////////////////////////
+
+  // Windows map a position in [-1; 1] across the kernel to a weight
+
+  struct Rectangular {
+    constexpr double operator()(double) const noexcept
+    {
+      return 1;
+    }
+  };
+
+  struct Hann {
+    constexpr double operator()(double x) const noexcept
+    {
+      return 0.5 + 0.5 * util::math::cos(util::math::pi * x);
+    }
+  };
+
+  struct Hamming {
+    constexpr double operator()(double x) const noexcept
+    {
+      return 0.54 + 0.46 * util::math::cos(util::math::pi * x);
+    }
+  };
+
+  struct Blackman {
+    constexpr double operator()(double x) const noexcept
+    {
+      return 0.42 + 0.5 * util::math::cos(util::math::pi * x) + 0.08 * util::math::cos(2 * util::math::pi * x);
+    }
+  };
+
+  /// Kaiser window. `beta` trades transition width for stopband attenuation, see `kaiser_beta`
+  struct Kaiser {
+    double beta;
+    constexpr double operator()(double x) const noexcept
+    {
+      return util::math::bessel_i0(beta * util::math::sqrt(1 - x * x)) / util::math::bessel_i0(beta);
+    }
+  };
+
+  /// Kaiser `beta` for a stopband attenuation of `attenuation` dB
+  constexpr double kaiser_beta(double attenuation) noexcept
+  {
+    if (attenuation > 50) return 0.1102 * (attenuation - 8.7);
+    if (attenuation >= 21) return 0.5842 * util::math::pow(attenuation - 21, 0.4) + 0.07886 * (attenuation - 21);
+    return 0;
+  }
+
+  /// Smallest odd number of taps for a Kaiser windowed filter with a stopband attenuation of
+  /// `attenuation` dB and the given transition width.
+  ///
+  /// Uses Kaiser's estimate, so the attenuation right at the edge of the stopband may fall
+  /// short by a dB or two.
+  constexpr std::size_t kaiser_taps(double attenuation, double transition_width) noexcept
+  {
+    const double n = (attenuation - 7.95) / (14.36 * transition_width);
+    auto taps = static_cast<std::size_t>(n) + (n > static_cast<double>(static_cast<std::size_t>(n)) ? 1 : 0) + 1;
+    return taps | 1;
+  }
+
+  /// Smallest number of taps of the form `4k + 3` for a Kaiser windowed halfband filter.
+  ///
+  /// Every other tap of a halfband filter is zero, and this length makes the first and last taps non-zero.
+  constexpr std::size_t kaiser_halfband_taps(double attenuation, double transition_width) noexcept
+  {
+    const auto taps = kaiser_taps(attenuation, transition_width);
+    return taps % 4 == 3 ? taps : taps + 2;
+  }
+
+  // DESIGNERS /////////////////////////////////////////
+
+  /// Lowpass kernel of `N` taps, made by windowing an ideal lowpass at `cutoff`.
+  ///
+  /// Normalized to unity gain at DC.
+  template<std::size_t N>
+  constexpr std::array<float, N> windowed_sinc(double cutoff, auto window) noexcept
+  {
+    static_assert(N % 2 == 1, "Linear phase lowpass filters need an odd number of taps");
+    constexpr double m = (N - 1) / 2.0;
+    std::array<double, N> h = {};
+    double sum = 0;
+    for (std::size_t i = 0; i < N; i++) {
+      const double k = static_cast<double>(i) - m;
+      const double ideal = k == 0 ? 2 * cutoff : util::math::sin(2 * util::math::pi * cutoff * k) / (util::math::pi * k);
+      h[i] = ideal * (m == 0 ? 1 : window(k / m));
+      sum += h[i];
+    }
+    std::array<float, N> res = {};
+    for (std::size_t i = 0; i < N; i++) res[i] = static_cast<float>(h[i] / sum);
+    return res;
+  }
+
+  /// Lowpass specification, for designing a Kaiser windowed filter with the fewest taps
+  struct Lowpass {
+    /// Center of the transition band
+    double cutoff;
+    double transition_width;
+    /// Stopband attenuation in dB
+    double attenuation = 80;
+  };
+
+  /// Kaiser windowed lowpass filter with the fewest taps meeting `Spec`
+  template<Lowpass Spec>
+  constexpr auto lowpass() noexcept
+  {
+    constexpr auto taps = kaiser_taps(Spec.attenuation, Spec.transition_width);
+    return fir(windowed_sinc<taps>(Spec.cutoff, Kaiser{kaiser_beta(Spec.attenuation)}));
+  }
+
+  /// Kaiser windowed halfband filter with the fewest taps meeting the given transition width
+  /// and stopband attenuation. Every other tap is exactly zero.
+  template<Lowpass Spec>
+  requires(Spec.cutoff == 0.25) //
+    constexpr auto halfband() noexcept
+  {
+    constexpr auto taps = kaiser_halfband_taps(Spec.attenuation, Spec.transition_width);
+    auto kernel = windowed_sinc<taps>(0.25, Kaiser{kaiser_beta(Spec.attenuation)});
+    for (std::size_t i = 0; i < taps; i++) {
+      const auto k = static_cast<std::ptrdiff_t>(i) - static_cast<std::ptrdiff_t>(taps / 2);
+      if (k != 0 && k % 2 == 0) kernel[i] = 0;
+    }
+    return fir(kernel);
+  }
+
+} // namespace eda::design
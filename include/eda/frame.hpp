@@ -1,15 +1,46 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <span>
 
 namespace eda {
 
+  namespace detail {
+    /// `Channels` rounded up to a power of two, or to a multiple of 16 above 16, so whole frames fit SIMD registers
+    template<std::size_t Channels>
+    constexpr std::size_t padded_channels = (Channels + std::min<std::size_t>(16, std::bit_ceil(Channels)) - 1) /
+                                            std::min<std::size_t>(16, std::bit_ceil(Channels)) *
+                                            std::min<std::size_t>(16, std::bit_ceil(Channels));
+
+    /// Number of floats a `Frame<Channels>` stores.
+    ///
+    /// Frames are padded to `padded_channels` when `EDA_PAD_FRAMES` is defined, which makes every
+    /// frame SIMD aligned at the cost of memory, and are otherwise stored without padding.
+#ifdef EDA_PAD_FRAMES
+    template<std::size_t Channels>
+    constexpr std::size_t frame_storage = padded_channels<Channels>;
+#else
+    template<std::size_t Channels>
+    constexpr std::size_t frame_storage = Channels;
+#endif
+
+    /// The largest power of two up to 64 that divides the size of `Channels` floats.
+    ///
+    /// Aligns frames for SIMD loads whenever that does not require padding.
+    template<std::size_t Channels>
+    constexpr std::size_t frame_alignment = std::min<std::size_t>(64, (Channels * sizeof(float)) & -(Channels * sizeof(float)));
+  } // namespace detail
+
   template<std::size_t Channels>
   struct Frame {
     constexpr Frame() = default;
-    constexpr Frame(std::array<float, Channels> data) : data_(data) {}
+    constexpr Frame(std::array<float, Channels> data)
+    {
+      std::copy(data.begin(), data.end(), data_.begin());
+    }
     constexpr Frame(auto... floats) requires(sizeof...(floats) == Channels &&
                                              (std::convertible_to<decltype(floats), float> && ...))
       : data_{static_cast<float>(floats)...}
@@ -30,7 +61,7 @@ namespace eda {
     }
     [[nodiscard]] constexpr auto end() const noexcept
     {
-      return data_.end();
+      return data_.begin() + Channels;
     }
 
     constexpr auto begin()
@@ -39,7 +70,7 @@ namespace eda {
     }
     constexpr auto end()
     {
-      return data_.end();
+      return data_.begin() + Channels;
     }
 
     constexpr float& operator[](std::size_t Idx)
@@ -47,6 +78,11 @@ namespace eda {
       return data_[Idx];
     }
 
+    constexpr float operator[](std::size_t Idx) const
+    {
+      return data_[Idx];
+    }
+
     constexpr float* data()
     {
       return data_.data();
@@ -65,9 +101,9 @@ namespace eda {
       return data_[0] == f;
     }
 
-  private : //
-            std::array<float, Channels>
-              data_ = {0};
+  private:
+    /// Padding, if any, stays zero, so it doesn't change comparisons
+    alignas(detail::frame_alignment<detail::frame_storage<Channels>>) std::array<float, detail::frame_storage<Channels>> data_ = {0};
   };
 
   template<>
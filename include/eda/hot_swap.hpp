@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "eda/buffer.hpp"
+#include "eda/erased.hpp"
+#include "eda/internal/spsc_queue.hpp"
+
+namespace eda {
+
+  // HOT SWAP //////////////////////////////////////////
+
+  /// Runs a graph that can be replaced while processing, without allocating or blocking on the audio thread.
+  ///
+  /// A control thread builds the evaluator of the new graph and hands it over with `publish`. The audio
+  /// thread picks it up at the start of the next `process`, and crossfades from the old graph to the new
+  /// one over `crossfade` frames, running both meanwhile. Once faded out, the old evaluator is passed
+  /// back to be destroyed by the control thread in `collect`.
+  ///
+  /// `publish` and `collect` must be called from a single control thread, and `process` from a single
+  /// audio thread. When several graphs are published before the audio thread picks them up, only the
+  /// last one is used. A graph published during a crossfade waits for it to finish.
+  template<std::size_t In, std::size_t Out>
+  struct HotSwap {
+    using evaluator_ptr = std::unique_ptr<ErasedEvaluator<In, Out>>;
+
+    explicit HotSwap(std::size_t crossfade = 1024) noexcept : crossfade_(crossfade) {}
+
+    HotSwap(const HotSwap&) = delete;
+    HotSwap& operator=(const HotSwap&) = delete;
+
+    ~HotSwap()
+    {
+      delete pending_.load(std::memory_order_acquire);
+      delete current_;
+      delete fading_;
+      collect();
+    }
+
+    /// Replace the graph with `block`. Makes its evaluator on the calling thread
+    void publish(const Erased<In, Out>& block)
+    {
+      publish(block.block->make_evaluator());
+    }
+
+    /// Replace the graph, evaluating it with `e`
+    void publish(evaluator_ptr e)
+    {
+      // Not picked up by the audio thread yet, so replaced
+      delete pending_.exchange(e.release(), std::memory_order_acq_rel);
+      collect();
+    }
+
+    /// Destroy the evaluators the audio thread is done with
+    void collect() noexcept
+    {
+      retired_.consume_all([](ErasedEvaluator<In, Out>* e) { delete e; });
+    }
+
+    /// Whether a crossfade is in progress
+    [[nodiscard]] bool swapping() const noexcept
+    {
+      return fading_ != nullptr;
+    }
+
+    /// Process a buffer with the current graph, crossfading from the previous one after a swap.
+    ///
+    /// Outputs silence until a graph has been published. `in` and `out` may share channel buffers.
+    void process(BufferView<In> in, BufferView<Out> out) noexcept
+    {
+      if (fading_ == nullptr) take_pending();
+      if (current_ == nullptr) {
+        for (std::size_t c = 0; c < Out; c++) std::fill_n(out[c], out.size(), 0.f);
+        return;
+      }
+      std::size_t start = 0;
+      // Both graphs run on the same input, so the old one writes to scratch first
+      ScratchBuffer<Out> scratch;
+      while (fading_ != nullptr && fade_pos_ < crossfade_ && start < in.size()) {
+        const auto n = std::min({process_chunk, in.size() - start, crossfade_ - fade_pos_});
+        const auto in_chunk = in.subview(start, n);
+        auto old_out = scratch.view(n);
+        run(*fading_, in_chunk, old_out);
+        auto out_chunk = out.subview(start, n);
+        run(*current_, in_chunk, out_chunk);
+        for (std::size_t c = 0; c < Out; c++) {
+          for (std::size_t i = 0; i < n; i++) {
+            const float gain = static_cast<float>(fade_pos_ + i + 1) / crossfade_;
+            out_chunk[c][i] = old_out[c][i] + gain * (out_chunk[c][i] - old_out[c][i]);
+          }
+        }
+        fade_pos_ += n;
+        start += n;
+      }
+      // Kept until the control thread has made room to retire it
+      if (fading_ != nullptr && fade_pos_ >= crossfade_ && retired_.push(fading_)) fading_ = nullptr;
+      if (start < in.size()) {
+        run(*current_, in.subview(start, in.size() - start), out.subview(start, out.size() - start));
+      }
+    }
+
+  private:
+    static void run(ErasedEvaluator<In, Out>& e, BufferView<In> in, BufferView<Out> out) noexcept
+    {
+      e.begin_buffer(std::max(in.size(), out.size()));
+      e.process(in, out);
+      e.end_buffer();
+    }
+
+    void take_pending() noexcept
+    {
+      auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+      if (next == nullptr) return;
+      // Without a crossfade, the old evaluator is retired right away
+      fading_ = std::exchange(current_, next);
+      fade_pos_ = 0;
+    }
+
+    std::size_t crossfade_;
+    std::atomic<ErasedEvaluator<In, Out>*> pending_ = nullptr;
+    /// Evaluators to destroy on the control thread
+    util::SpscQueue<ErasedEvaluator<In, Out>*, 8> retired_;
+    // Owned by the audio thread
+    ErasedEvaluator<In, Out>* current_ = nullptr;
+    ErasedEvaluator<In, Out>* fading_ = nullptr;
+    std::size_t fade_pos_ = 0;
+  };
+
+} // namespace eda
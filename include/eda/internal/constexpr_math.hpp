@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+
+/// Math functions usable in constant expressions, where `<cmath>` is not.
+///
+/// Accurate to about double precision on the ranges needed for filter design,
+/// but slower than `<cmath>`, so only meant to be evaluated at compile time.
+namespace eda::util::math {
+
+  constexpr double pi = 3.14159265358979323846;
+  constexpr double ln2 = 0.69314718055994530942;
+
+  constexpr double abs(double x) noexcept
+  {
+    return x < 0 ? -x : x;
+  }
+
+  constexpr double sin(double x) noexcept
+  {
+    // Reduce to [-pi, pi], where the series converges quickly
+    const double turns = x / (2 * pi);
+    x -= 2 * pi * static_cast<double>(static_cast<long long>(turns + (turns >= 0 ? 0.5 : -0.5)));
+    double term = x;
+    double res = x;
+    for (int n = 1; n < 30; n++) {
+      term *= -x * x / ((2 * n) * (2 * n + 1));
+      res += term;
+    }
+    return res;
+  }
+
+  constexpr double cos(double x) noexcept
+  {
+    return sin(x + pi / 2);
+  }
+
+  constexpr double sqrt(double x) noexcept
+  {
+    if (x <= 0) return 0;
+    double res = x < 1 ? 1 : x;
+    for (int i = 0; i < 100; i++) {
+      const double next = 0.5 * (res + x / res);
+      if (next == res) break;
+      res = next;
+    }
+    return res;
+  }
+
+  constexpr double exp(double x) noexcept
+  {
+    // exp(x) = exp(x / 2^k)^(2^k), with |x / 2^k| < 0.5
+    int k = 0;
+    while (abs(x) > 0.5) {
+      x /= 2;
+      k++;
+    }
+    double term = 1;
+    double res = 1;
+    for (int n = 1; n < 20; n++) {
+      term *= x / n;
+      res += term;
+    }
+    for (; k > 0; k--) res *= res;
+    return res;
+  }
+
+  /// Natural logarithm of `x > 0`
+  constexpr double log(double x) noexcept
+  {
+    // log(x) = log(m) + e * log(2), with m in [0.5, 1]
+    int e = 0;
+    while (x > 1) {
+      x /= 2;
+      e++;
+    }
+    while (x < 0.5) {
+      x *= 2;
+      e--;
+    }
+    // log(m) = 2 * atanh((m - 1) / (m + 1))
+    const double y = (x - 1) / (x + 1);
+    double term = y;
+    double res = 0;
+    for (int n = 1; n < 60; n += 2) {
+      res += term / n;
+      term *= y * y;
+    }
+    return 2 * res + e * ln2;
+  }
+
+  constexpr double pow(double x, double y) noexcept
+  {
+    return x <= 0 ? 0 : exp(y * log(x));
+  }
+
+  /// Zeroth order modified Bessel function of the first kind
+  constexpr double bessel_i0(double x) noexcept
+  {
+    double term = 1;
+    double res = 1;
+    for (int k = 1; k < 200; k++) {
+      term *= (x / (2 * k)) * (x / (2 * k));
+      res += term;
+      if (term < res * 1e-17) break;
+    }
+    return res;
+  }
+
+} // namespace eda::util::math
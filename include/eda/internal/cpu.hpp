@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EDA_X86_DISPATCH 1
+#include <immintrin.h>
+#else
+#define EDA_X86_DISPATCH 0
+#endif
+
+// Compile a kernel for an instruction set level, with everything it calls inlined into it, so the
+// whole loop is vectorized for that level. Select the version to call with `util::Multiversioned`.
+// Elsewhere than on x86, these compile the generic code, which is never selected.
+#if EDA_X86_DISPATCH
+#define EDA_TARGET_SSE42 __attribute__((target("sse4.2,popcnt"), flatten))
+#define EDA_TARGET_AVX2 __attribute__((target("avx2,fma,f16c"), flatten))
+#define EDA_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,f16c"), flatten))
+#else
+#define EDA_TARGET_SSE42
+#define EDA_TARGET_AVX2
+#define EDA_TARGET_AVX512
+#endif
+
+// Inline everything a function calls into it, for loops that evaluate a whole graph each frame,
+// which would otherwise call each block through the compiler's inlining limits.
+#if defined(__GNUC__) || defined(__clang__)
+#define EDA_FLATTEN __attribute__((flatten))
+#else
+#define EDA_FLATTEN
+#endif
+
+namespace eda::util {
+
+  // CPU FEATURES //////////////////////////////////////
+
+  /// Instruction set levels kernels are compiled for, each including the previous ones.
+  ///
+  /// Follow the x86-64 microarchitecture levels: `sse42` is x86-64-v2, `avx2` is x86-64-v3,
+  /// with FMA and F16C, and `avx512` is x86-64-v4.
+  enum struct Isa { generic, sse42, avx2, avx512 };
+
+  constexpr std::string_view isa_name(Isa isa) noexcept
+  {
+    switch (isa) {
+      case Isa::generic: return "generic";
+      case Isa::sse42: return "sse4.2";
+      case Isa::avx2: return "avx2";
+      case Isa::avx512: return "avx512";
+    }
+    return "generic";
+  }
+
+  /// The level named `name` by `isa_name`
+  constexpr std::optional<Isa> parse_isa(std::string_view name) noexcept
+  {
+    for (auto isa : {Isa::generic, Isa::sse42, Isa::avx2, Isa::avx512}) {
+      if (isa_name(isa) == name) return isa;
+    }
+    return std::nullopt;
+  }
+
+  /// CPU features the levels are made of
+  struct CpuFeatures {
+    bool sse42 = false;
+    bool popcnt = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+    bool avx512vl = false;
+    bool avx512bw = false;
+    bool avx512dq = false;
+  };
+
+  /// Highest level whose features, and those of the levels below it, are all in `f`
+  constexpr Isa isa_for(const CpuFeatures& f) noexcept
+  {
+    const bool v2 = f.sse42 && f.popcnt;
+    const bool v3 = v2 && f.avx2 && f.fma && f.f16c;
+    const bool v4 = v3 && f.avx512f && f.avx512vl && f.avx512bw && f.avx512dq;
+    if (v4) return Isa::avx512;
+    if (v3) return Isa::avx2;
+    if (v2) return Isa::sse42;
+    return Isa::generic;
+  }
+
+  namespace detail {
+    inline Isa detect_isa() noexcept
+    {
+#if EDA_X86_DISPATCH
+      __builtin_cpu_init();
+      return isa_for({
+        .sse42 = __builtin_cpu_supports("sse4.2") != 0,
+        .popcnt = __builtin_cpu_supports("popcnt") != 0,
+        .avx2 = __builtin_cpu_supports("avx2") != 0,
+        .fma = __builtin_cpu_supports("fma") != 0,
+        .f16c = __builtin_cpu_supports("f16c") != 0,
+        .avx512f = __builtin_cpu_supports("avx512f") != 0,
+        .avx512vl = __builtin_cpu_supports("avx512vl") != 0,
+        .avx512bw = __builtin_cpu_supports("avx512bw") != 0,
+        .avx512dq = __builtin_cpu_supports("avx512dq") != 0,
+      });
+#else
+      return Isa::generic;
+#endif
+    }
+
+    /// Highest level kernels may use, initially set by the `EDA_ISA` environment variable
+    inline std::atomic<Isa>& isa_limit() noexcept
+    {
+      static std::atomic<Isa> limit = [] {
+        const char* env = std::getenv("EDA_ISA");
+        return env != nullptr ? parse_isa(env).value_or(Isa::avx512) : Isa::avx512;
+      }();
+      return limit;
+    }
+  } // namespace detail
+
+  /// Highest level supported by this CPU
+  inline Isa supported_isa() noexcept
+  {
+    static const Isa isa = detail::detect_isa();
+    return isa;
+  }
+
+  /// Level kernels are selected for: the supported level, unless lowered by `force_isa`
+  inline Isa isa() noexcept
+  {
+    return std::min(supported_isa(), detail::isa_limit().load(std::memory_order_relaxed));
+  }
+
+  /// Select kernels for `isa` from now on, or for the supported level if `isa` is higher. Returns the level in use.
+  ///
+  /// Meant for benchmarks and tests. Evaluators select their kernels when they are made, so
+  /// existing evaluators keep theirs. Can also be set with the `EDA_ISA` environment variable,
+  /// to one of the names of `isa_name`.
+  inline Isa force_isa(Isa isa) noexcept
+  {
+    detail::isa_limit().store(isa, std::memory_order_relaxed);
+    return util::isa();
+  }
+
+  /// Versions of a kernel function for each level. Only `generic` is required.
+  template<typename F>
+  struct Multiversioned {
+    F generic;
+    F sse42 = nullptr;
+    F avx2 = nullptr;
+    F avx512 = nullptr;
+
+    /// The version for `level`, or for the closest lower level that has one
+    [[nodiscard]] F select(Isa level = isa()) const noexcept
+    {
+      if (level >= Isa::avx512 && avx512 != nullptr) return avx512;
+      if (level >= Isa::avx2 && avx2 != nullptr) return avx2;
+      if (level >= Isa::sse42 && sse42 != nullptr) return sse42;
+      return generic;
+    }
+  };
+
+} // namespace eda::util
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+/// A small, self-contained FFT for real signals.
+///
+/// Radix-2, with complex numbers stored as separate arrays of real and imaginary parts, so the
+/// butterflies of each stage and products of spectra vectorize.
+namespace eda::util {
+
+  /// Tables for the FFT of real signals of a fixed power of two size.
+  ///
+  /// Immutable, so a plan can be shared by all transforms of the same size, see `RealFFT`.
+  struct FFTPlan {
+    /// `size` must be a power of two, of at least 4
+    explicit FFTPlan(std::size_t n) : size(n), reversed(n / 2), twiddle_re(n / 2), twiddle_im(n / 2), untangle(n / 2)
+    {
+      const auto m = n / 2;
+      const auto bits = std::countr_zero(m);
+      for (std::size_t i = 0; i < m; i++) {
+        for (int b = 0; b < bits; b++) reversed[i] |= ((i >> b) & 1) << (bits - 1 - b);
+      }
+      // The twiddles of the stage with butterflies `half` apart start at `half - 1`
+      for (std::size_t half = 1; half < m; half *= 2) {
+        for (std::size_t j = 0; j < half; j++) {
+          const double angle = -std::numbers::pi * j / half;
+          twiddle_re[half - 1 + j] = static_cast<float>(std::cos(angle));
+          twiddle_im[half - 1 + j] = static_cast<float>(std::sin(angle));
+        }
+      }
+      for (std::size_t k = 0; k < m; k++) untangle[k] = std::polar(1.f, float(-2 * std::numbers::pi * k / n));
+    }
+
+    /// Number of samples of the signal
+    std::size_t size;
+    /// Index of each element of the half size complex FFT once the bits of the index are reversed
+    std::vector<std::size_t> reversed;
+    /// Twiddles of all stages of the complex FFT, one after the other
+    std::vector<float> twiddle_re;
+    std::vector<float> twiddle_im;
+    /// Twiddles to separate the spectra of the even and odd samples
+    std::vector<std::complex<float>> untangle;
+  };
+
+  /// Forward and inverse FFT of real signals of a fixed power of two size.
+  ///
+  /// Computes the `size() / 2` point complex FFT of the even and odd samples packed as real and
+  /// imaginary parts, and untangles the result. Owns its working memory, so transforms never allocate,
+  /// but an instance must not be used by several threads at once.
+  struct RealFFT {
+    RealFFT() = default;
+
+    /// `size` must be a power of two, of at least 4
+    explicit RealFFT(std::size_t size) : RealFFT(std::make_shared<const FFTPlan>(size)) {}
+
+    /// Transforms using the tables of `plan`, which may be shared with other instances
+    explicit RealFFT(std::shared_ptr<const FFTPlan> plan)
+      : plan_(std::move(plan)), n_(plan_->size), m_(n_ / 2), work_re_(m_), work_im_(m_)
+    {}
+
+    [[nodiscard]] const std::shared_ptr<const FFTPlan>& plan() const noexcept
+    {
+      return plan_;
+    }
+
+    /// Number of samples of the signal
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return n_;
+    }
+
+    /// Number of bins of the spectrum, from DC to Nyquist
+    [[nodiscard]] std::size_t bins() const noexcept
+    {
+      return m_ + 1;
+    }
+
+    /// Spectrum of the `size()` samples of `in`, as `bins()` real and imaginary parts
+    void forward(const float* in, float* re, float* im) noexcept
+    {
+      for (std::size_t k = 0; k < m_; k++) {
+        work_re_[plan_->reversed[k]] = in[2 * k];
+        work_im_[plan_->reversed[k]] = in[2 * k + 1];
+      }
+      transform<false>();
+      // Bins 0 and `m_` only mix the real and imaginary parts of the first bin
+      re[0] = work_re_[0] + work_im_[0];
+      re[m_] = work_re_[0] - work_im_[0];
+      im[0] = im[m_] = 0;
+      for (std::size_t k = 1; k < m_; k++) {
+        const std::complex<float> z = {work_re_[k], work_im_[k]};
+        const std::complex<float> zc = {work_re_[m_ - k], -work_im_[m_ - k]};
+        // Spectra of the even and odd samples
+        const auto even = (z + zc) * 0.5f;
+        const auto odd = mul(z - zc, {0, -0.5f});
+        const auto x = even + mul(odd, plan_->untangle[k]);
+        re[k] = x.real();
+        im[k] = x.imag();
+      }
+    }
+
+    /// Signal of `size()` samples with the spectrum `re`, `im`, scaled by `size()`
+    void inverse(const float* re, const float* im, float* out) noexcept
+    {
+      for (std::size_t k = 0; k < m_; k++) {
+        const std::complex<float> x = {re[k], im[k]};
+        const std::complex<float> xc = {re[m_ - k], -im[m_ - k]};
+        const auto even = (x + xc) * 0.5f;
+        const auto odd = mul((x - xc) * 0.5f, std::conj(plan_->untangle[k]));
+        const auto z = even + mul(odd, {0, 1});
+        work_re_[plan_->reversed[k]] = z.real();
+        work_im_[plan_->reversed[k]] = z.imag();
+      }
+      transform<true>();
+      for (std::size_t k = 0; k < m_; k++) {
+        out[2 * k] = 2 * work_re_[k];
+        out[2 * k + 1] = 2 * work_im_[k];
+      }
+    }
+
+  private:
+    /// Complex multiplication, without the checks for infinities `std::complex` does
+    static std::complex<float> mul(std::complex<float> a, std::complex<float> b) noexcept
+    {
+      return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+    }
+
+    /// In-place radix-2 FFT of the bit reversed `work_re_` and `work_im_`, without scaling
+    template<bool Inverse>
+    void transform() noexcept
+    {
+      constexpr float sign = Inverse ? -1 : 1;
+      float* __restrict wr = work_re_.data();
+      float* __restrict wi = work_im_.data();
+      for (std::size_t half = 1; half < m_; half *= 2) {
+        const float* __restrict tr = plan_->twiddle_re.data() + half - 1;
+        const float* __restrict ti = plan_->twiddle_im.data() + half - 1;
+        for (std::size_t i = 0; i < m_; i += 2 * half) {
+          float* __restrict ar = wr + i;
+          float* __restrict ai = wi + i;
+          float* __restrict br = wr + i + half;
+          float* __restrict bi = wi + i + half;
+          for (std::size_t j = 0; j < half; j++) {
+            const float vr = br[j] * tr[j] - bi[j] * sign * ti[j];
+            const float vi = br[j] * sign * ti[j] + bi[j] * tr[j];
+            br[j] = ar[j] - vr;
+            bi[j] = ai[j] - vi;
+            ar[j] += vr;
+            ai[j] += vi;
+          }
+        }
+      }
+    }
+
+    std::shared_ptr<const FFTPlan> plan_;
+    std::size_t n_ = 0;
+    std::size_t m_ = 0;
+    std::vector<float> work_re_;
+    std::vector<float> work_im_;
+  };
+
+} // namespace eda::util
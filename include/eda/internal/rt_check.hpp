@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <typeinfo>
+
+namespace eda::detail {
+
+  /// Calls made while a real-time check was active on the current thread, see `rt_check_process`
+  struct RtViolations {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t locks = 0;
+    /// Innermost block being processed at the first violation
+    const std::type_info* block = nullptr;
+  };
+
+  /// State of the real-time check of the current thread.
+  ///
+  /// Trivial, so the interposed allocation functions can use it without allocating or initializing it.
+  struct RtCheckState {
+    bool active = false;
+    const std::type_info* block = nullptr;
+    RtViolations violations;
+  };
+
+  inline thread_local RtCheckState rt_check_state;
+
+  /// Set by the translation unit which defines `EDA_RT_CHECK_IMPLEMENTATION`, once its functions are interposed
+  inline std::atomic<bool> rt_check_installed = false;
+
+  enum struct RtCall { allocation, deallocation, lock };
+
+  /// Called by the interposed functions
+  inline void rt_check_call(RtCall call) noexcept
+  {
+    auto& state = rt_check_state;
+    if (!state.active) return;
+    auto& v = state.violations;
+    if (v.allocations + v.deallocations + v.locks == 0) v.block = state.block;
+    switch (call) {
+      case RtCall::allocation: v.allocations++; break;
+      case RtCall::deallocation: v.deallocations++; break;
+      case RtCall::lock: v.locks++; break;
+    }
+  }
+
+  /// Marks the block being processed by the current thread, so violations name the innermost block.
+  ///
+  /// Does nothing during constant evaluation, so it can be used in `constexpr` evaluators.
+  struct RtBlockScope {
+    constexpr explicit RtBlockScope(const std::type_info& block) noexcept
+    {
+      if (std::is_constant_evaluated()) return;
+      previous_ = rt_check_state.block;
+      rt_check_state.block = &block;
+    }
+
+    RtBlockScope(const RtBlockScope&) = delete;
+    RtBlockScope& operator=(const RtBlockScope&) = delete;
+
+    constexpr ~RtBlockScope()
+    {
+      if (std::is_constant_evaluated()) return;
+      rt_check_state.block = previous_;
+    }
+
+  private:
+    const std::type_info* previous_ = nullptr;
+  };
+
+} // namespace eda::detail
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+namespace eda::util {
+
+  /// Lock-free, bounded, single producer single consumer queue.
+  ///
+  /// One slot is always kept free, so at most `Capacity - 1` items can be queued.
+  template<typename T, std::size_t Capacity>
+  requires(Capacity > 1 && std::is_trivially_copyable_v<T>) //
+    struct SpscQueue {
+    /// Push all of `items`, or none of them if there is not enough room.
+    ///
+    /// The consumer sees either all items of a batch or none of them.
+    bool push(std::span<const T> items) noexcept
+    {
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      const auto head = head_.load(std::memory_order_acquire);
+      const auto used = (tail + Capacity - head) % Capacity;
+      if (used + items.size() >= Capacity) return false;
+      for (std::size_t i = 0; i < items.size(); i++) {
+        data_[(tail + i) % Capacity] = items[i];
+      }
+      tail_.store((tail + items.size()) % Capacity, std::memory_order_release);
+      return true;
+    }
+
+    bool push(const T& item) noexcept
+    {
+      return push(std::span<const T>(&item, 1));
+    }
+
+    std::optional<T> pop() noexcept
+    {
+      const auto head = head_.load(std::memory_order_relaxed);
+      if (head == tail_.load(std::memory_order_acquire)) return std::nullopt;
+      T res = data_[head];
+      head_.store((head + 1) % Capacity, std::memory_order_release);
+      return res;
+    }
+
+    /// Pop all queued items, calling `f` with each of them
+    void consume_all(auto&& f) noexcept
+    {
+      const auto tail = tail_.load(std::memory_order_acquire);
+      auto head = head_.load(std::memory_order_relaxed);
+      for (; head != tail; head = (head + 1) % Capacity) {
+        f(data_[head]);
+      }
+      head_.store(head, std::memory_order_release);
+    }
+
+  private:
+    alignas(64) std::atomic<std::size_t> head_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_ = 0;
+    std::array<T, Capacity> data_;
+  };
+
+} // namespace eda::util
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "eda/block.hpp"
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/internal/cpu.hpp"
+
+namespace eda {
+
+  // MIX ///////////////////////////////////////////////
+
+  /// Mixes `In` inputs into `Out` outputs, through a matrix of gains.
+  ///
+  /// Output `o` is the sum of each input `i` times `gains[o * In + i]`. Like `Ref`, the block
+  /// points to the gains rather than holding them, so they can be changed while it runs.
+  template<std::size_t In, std::size_t Out>
+  struct Mix : BlockBase<Mix<In, Out>, In, Out> {
+    const float* gains = nullptr;
+  };
+
+  /// Mix through the row-major `Out` by `In` matrix `gains`, see `Mix`.
+  ///
+  /// The gains can live in a `ParameterStore`, with `store.snapshot_values().template subspan<Offset, In * Out>()`.
+  template<std::size_t In, std::size_t Out>
+  constexpr Mix<In, Out> mix(std::span<const float, In * Out> gains) noexcept
+  {
+    return {{}, gains.data()};
+  }
+
+  template<std::size_t In, std::size_t Out>
+  struct is_stateless<Mix<In, Out>> : std::true_type {};
+
+  /// Every output is a weighted sum of all inputs
+  template<std::size_t In, std::size_t Out>
+  struct affinity<Mix<In, Out>> {
+    static constexpr Dependencies<Out> apply(Dependencies<In> in) noexcept
+    {
+      auto sum = Dependency::constant;
+      for (auto d : in) sum = detail::add_dependencies(sum, detail::mul_dependencies(Dependency::constant, d));
+      Dependencies<Out> res;
+      res.fill(sum);
+      return res;
+    }
+  };
+
+  template<std::size_t In, std::size_t Out>
+  struct evaluator<Mix<In, Out>> : EvaluatorBase<Mix<In, Out>> {
+    constexpr evaluator(const Mix<In, Out>& m) noexcept : gains_(m.gains)
+    {
+      if (!std::is_constant_evaluated()) process_ = kernels.select();
+    }
+
+    constexpr Frame<Out> eval(Frame<In> in) const
+    {
+      Frame<Out> res;
+      for (std::size_t o = 0; o < Out; o++) {
+        float sum = 0;
+        for (std::size_t i = 0; i < In; i++) sum += gains_[o * In + i] * in[i];
+        res[o] = sum;
+      }
+      return res;
+    }
+
+    /// Runs the kernel for the instruction set of the CPU the evaluator was made on
+    void process(BufferView<In> in, BufferView<Out> out) const
+    {
+      process_(gains_, in, out);
+    }
+
+  private:
+    static constexpr std::size_t rows = 4;
+
+    /// Frames summed in registers at once
+    static constexpr std::size_t width = 16;
+
+    using kernel = void (*)(const float*, BufferView<In>, BufferView<Out>) noexcept;
+
+    /// Reads the gains once per buffer, and computes `rows` outputs of `width` frames at a time,
+    /// so each input is loaded once per `rows` outputs, and the sums stay in registers.
+    static void process_generic(const float* gains_ptr, BufferView<In> in, BufferView<Out> out) noexcept
+    {
+      std::array<float, In * Out> gains;
+      std::copy_n(gains_ptr, In * Out, gains.begin());
+      // Written to scratch first, as `out` may be the same buffer as `in`
+      ScratchBuffer<Out> scratch;
+      for (std::size_t start = 0; start < in.size(); start += process_chunk) {
+        const auto n = std::min(process_chunk, in.size() - start);
+        auto chunk = scratch.view(n);
+        for (std::size_t o = 0; o < Out; o += rows) {
+          const auto r = std::min(rows, Out - o);
+          if (r == rows) {
+            accumulate<rows>(gains.data() + o * In, in, start, chunk, o);
+          } else {
+            // The last outputs, one at a time
+            for (std::size_t k = 0; k < r; k++) accumulate<1>(gains.data() + (o + k) * In, in, start, chunk, o + k);
+          }
+        }
+        for (std::size_t o = 0; o < Out; o++) std::copy_n(chunk[o], n, out[o] + start);
+      }
+    }
+
+    EDA_TARGET_AVX2 static void process_avx2(const float* gains, BufferView<In> in, BufferView<Out> out) noexcept
+    {
+      process_generic(gains, in, out);
+    }
+
+    EDA_TARGET_AVX512 static void process_avx512(const float* gains, BufferView<In> in, BufferView<Out> out) noexcept
+    {
+      process_generic(gains, in, out);
+    }
+
+    static constexpr util::Multiversioned<kernel> kernels = {
+      .generic = &process_generic,
+      .avx2 = &process_avx2,
+      .avx512 = &process_avx512,
+    };
+
+    /// Outputs `[first; first + R[` of frames `[start; start + chunk.size()[`, into `chunk`
+    template<std::size_t R>
+    static void accumulate(const float* gains,
+                           const BufferView<In>& in,
+                           std::size_t start,
+                           BufferView<Out>& chunk,
+                           std::size_t first) noexcept
+    {
+      std::size_t k = 0;
+      for (; k + width <= chunk.size(); k += width) {
+        // Fixed size, so the sums stay in vector registers across all inputs
+        float sums[R][width] = {};
+        for (std::size_t i = 0; i < In; i++) {
+          const float* src = in[i] + start + k;
+          for (std::size_t r = 0; r < R; r++) {
+            const float g = gains[r * In + i];
+            for (std::size_t j = 0; j < width; j++) sums[r][j] += g * src[j];
+          }
+        }
+        for (std::size_t r = 0; r < R; r++) std::copy_n(sums[r], width, chunk[first + r] + k);
+      }
+      for (; k < chunk.size(); k++) {
+        for (std::size_t r = 0; r < R; r++) {
+          float sum = 0;
+          for (std::size_t i = 0; i < In; i++) sum += gains[r * In + i] * in[i][start + k];
+          chunk[first + r][k] = sum;
+        }
+      }
+    }
+
+    const float* gains_;
+    kernel process_ = &process_generic;
+  };
+
+} // namespace eda
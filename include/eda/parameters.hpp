@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "eda/block.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/internal/spsc_queue.hpp"
+
+namespace eda {
+
+  // PARAMETER STORE ///////////////////////////////////
+
+  /// A change of one parameter in a `ParameterStore`
+  struct ParameterUpdate {
+    std::size_t index;
+    float value;
+  };
+
+  /// Thread safe storage for `N` parameters shared between a control thread and the audio thread.
+  ///
+  /// Parameters can be set from any thread with `set`, or in batches from a single control
+  /// thread with `push`. The audio thread calls `snapshot` once before processing each
+  /// buffer, which copies all parameters into plain floats. `Ref` blocks created with `ref`
+  /// point into the snapshot, so they see consistent values for the whole buffer, and reading
+  /// them is an ordinary load the compiler can hoist out of loops.
+  ///
+  /// Updates take effect in the order they were made: a batch pushed before a `set` of the
+  /// same parameter doesn't overwrite it when the snapshot applies the batch.
+  template<std::size_t N, std::size_t QueueSize = 256>
+  struct ParameterStore {
+    ParameterStore() = default;
+
+    ParameterStore(std::array<float, N> initial) noexcept
+    {
+      for (std::size_t i = 0; i < N; i++) {
+        slots_[i].value.store(pack(initial[i], 0), std::memory_order_relaxed);
+        snapshot_[i] = initial[i];
+      }
+    }
+
+    ParameterStore(const ParameterStore&) = delete;
+    ParameterStore& operator=(const ParameterStore&) = delete;
+
+    static constexpr std::size_t size()
+    {
+      return N;
+    }
+
+    /// Set parameter `i`. May be called from any thread.
+    void set(std::size_t i, float value) noexcept
+    {
+      slots_[i].value.store(pack(value, tick()), std::memory_order_relaxed);
+    }
+
+    /// The latest value of parameter `i`, without the batches that are still queued. May be called from any thread.
+    [[nodiscard]] float get(std::size_t i) const noexcept
+    {
+      return unpack(slots_[i].value.load(std::memory_order_relaxed));
+    }
+
+    /// Queue a batch of updates, which will be applied together by the next `snapshot`.
+    ///
+    /// Lock-free, but only one thread may push at a time. Returns false, without applying
+    /// any of the updates, if the queue is full.
+    bool push(std::span<const ParameterUpdate> updates) noexcept
+    {
+      if (updates.size() >= QueueSize) return false;
+      std::array<Queued, QueueSize> batch;
+      const auto stamp = tick();
+      for (std::size_t i = 0; i < updates.size(); i++) batch[i] = {updates[i], stamp};
+      return queue_.push(std::span(batch.data(), updates.size()));
+    }
+
+    bool push(ParameterUpdate update) noexcept
+    {
+      return push(std::span(&update, 1));
+    }
+
+    /// Apply queued updates and copy all parameters to the snapshot. Call from the audio thread.
+    void snapshot() noexcept
+    {
+      queue_.consume_all([this](const Queued& q) {
+        if (q.update.index >= N) return;
+        auto& slot = slots_[q.update.index].value;
+        auto current = slot.load(std::memory_order_relaxed);
+        // Unless the parameter was set after the batch was pushed
+        while (!is_newer(stamp_of(current), q.stamp) &&
+               !slot.compare_exchange_weak(current, pack(q.update.value, q.stamp), std::memory_order_relaxed)) {
+        }
+      });
+      for (std::size_t i = 0; i < N; i++) {
+        snapshot_[i] = unpack(slots_[i].value.load(std::memory_order_relaxed));
+      }
+    }
+
+    /// The value of parameter `i` as of the last `snapshot`. Only read on the audio thread.
+    [[nodiscard]] float snapshot_value(std::size_t i) const noexcept
+    {
+      return snapshot_[i];
+    }
+
+    /// The snapshot, for changing parameters on the audio thread, like with `process_events`
+    [[nodiscard]] std::span<float, N> snapshot_values() noexcept
+    {
+      return snapshot_;
+    }
+
+    /// A block reading parameter `i` from the snapshot
+    [[nodiscard]] Ref ref(std::size_t i) noexcept
+    {
+      return eda::ref(snapshot_[i]);
+    }
+
+  private:
+    /// An update queued by `push`, with the time of its batch
+    struct Queued {
+      ParameterUpdate update;
+      std::uint32_t stamp;
+    };
+
+    /// Each parameter has its own cache line, so writers don't contend. Holds the bits of the
+    /// value in the low half, and the time it was set or pushed at in the high half.
+    struct alignas(64) Slot {
+      std::atomic<std::uint64_t> value = 0;
+    };
+
+    /// The next time of a `set` or `push`, which only orders updates, and may wrap around
+    std::uint32_t tick() noexcept
+    {
+      return clock_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static std::uint64_t pack(float value, std::uint32_t stamp) noexcept
+    {
+      return std::uint64_t(stamp) << 32 | std::bit_cast<std::uint32_t>(value);
+    }
+
+    static float unpack(std::uint64_t bits) noexcept
+    {
+      return std::bit_cast<float>(static_cast<std::uint32_t>(bits));
+    }
+
+    static std::uint32_t stamp_of(std::uint64_t bits) noexcept
+    {
+      return static_cast<std::uint32_t>(bits >> 32);
+    }
+
+    /// Whether `a` is later than `b`, for times less than 2^31 updates apart
+    static bool is_newer(std::uint32_t a, std::uint32_t b) noexcept
+    {
+      return static_cast<std::int32_t>(a - b) > 0;
+    }
+
+    std::array<Slot, N> slots_;
+    alignas(64) std::array<float, N> snapshot_ = {};
+    alignas(64) std::atomic<std::uint32_t> clock_ = 0;
+    util::SpscQueue<Queued, QueueSize> queue_;
+  };
+
+  // PARAMETER EVENTS //////////////////////////////////
+
+  /// A change of parameter `index` to `value`, taking effect at frame `time` of a buffer
+  struct ParameterEvent {
+    std::size_t time;
+    std::size_t index;
+    float value;
+  };
+
+  /// Process a buffer, changing `params` at the exact frames given by `events`.
+  ///
+  /// `events` must be sorted by time. The buffer is split into runs at the times of the events,
+  /// and each run is processed with `process`, so control rate subgraphs are evaluated once per
+  /// run, rather than reading parameters every frame. Smoothed parameters ramp over the run
+  /// that follows an event. Events past the end of the buffer are applied after processing it,
+  /// and events with an index outside of `params` are ignored.
+  template<typename E>
+  constexpr void process_events(E& e,
+                                BufferView<ins<block_for_t<E>>> in,
+                                BufferView<outs<block_for_t<E>>> out,
+                                std::span<const ParameterEvent> events,
+                                std::span<float> params)
+  {
+    auto event = events.begin();
+    auto apply_until = [&](std::size_t time) {
+      for (; event != events.end() && event->time <= time; ++event) {
+        if (event->index < params.size()) params[event->index] = event->value;
+      }
+    };
+    const auto n = std::max(in.size(), out.size());
+    for (std::size_t start = 0; start < n;) {
+      apply_until(start);
+      const auto end = event == events.end() ? n : std::min(event->time, n);
+      process(e, in.subview(start, end - start), out.subview(start, end - start));
+      start = end;
+    }
+    apply_until(std::numeric_limits<std::size_t>::max());
+  }
+
+} // namespace eda
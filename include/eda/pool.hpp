@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "eda/evaluator.hpp"
+
+namespace eda {
+
+  // EVALUATOR POOL ////////////////////////////////////
+
+  /// A fixed set of evaluators, constructed up front, handed out and taken back without locking.
+  ///
+  /// All instances are copies of one prototype evaluator, so constructing the pool builds
+  /// the evaluator from its block only once. Instances are reset with `eda::reset` when they
+  /// are released, which never reallocates, so `acquire` only has to pop a free list.
+  ///
+  /// `acquire` and `release` may be called concurrently from any number of threads.
+  /// `Evaluator` may be `evaluator<Block>` or `ArenaEvaluator<Block>`.
+  template<typename Evaluator>
+  struct EvaluatorPool {
+    /// An acquired instance. Released back to the pool when destroyed.
+    struct Handle {
+      Handle() = default;
+      Handle(const Handle&) = delete;
+      Handle(Handle&& rhs) noexcept : pool_(std::exchange(rhs.pool_, nullptr)), index_(rhs.index_) {}
+      Handle& operator=(Handle rhs) noexcept
+      {
+        std::swap(pool_, rhs.pool_);
+        std::swap(index_, rhs.index_);
+        return *this;
+      }
+      ~Handle()
+      {
+        release();
+      }
+
+      /// Whether the handle holds an instance. False when the pool was exhausted.
+      explicit operator bool() const noexcept
+      {
+        return pool_ != nullptr;
+      }
+
+      Evaluator& operator*() const noexcept
+      {
+        return pool_->instances_[index_];
+      }
+
+      Evaluator* operator->() const noexcept
+      {
+        return &pool_->instances_[index_];
+      }
+
+      /// Index of the instance in the pool
+      [[nodiscard]] std::size_t index() const noexcept
+      {
+        return index_;
+      }
+
+      /// Reset the instance and return it to the pool
+      void release() noexcept
+      {
+        if (pool_ != nullptr) std::exchange(pool_, nullptr)->release(index_);
+      }
+
+    private:
+      friend struct EvaluatorPool;
+      Handle(EvaluatorPool* pool, std::uint32_t index) noexcept : pool_(pool), index_(index) {}
+
+      EvaluatorPool* pool_ = nullptr;
+      std::uint32_t index_ = 0;
+    };
+
+    /// Make `size` instances in the initial state of `prototype`
+    EvaluatorPool(const Evaluator& prototype, std::size_t size)
+      : instances_(size, clone(prototype)), next_(std::make_unique<std::atomic<std::uint32_t>[]>(size))
+    {
+      for (std::size_t i = 0; i < size; i++) next_[i].store(static_cast<std::uint32_t>(i + 1));
+      if (size > 0) next_[size - 1].store(nil);
+      head_.store(size > 0 ? 0 : nil);
+    }
+
+    EvaluatorPool(const EvaluatorPool&) = delete;
+    EvaluatorPool& operator=(const EvaluatorPool&) = delete;
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return instances_.size();
+    }
+
+    /// Take an instance from the pool, in its initial state.
+    ///
+    /// Returns an empty handle if all instances are in use.
+    [[nodiscard]] Handle acquire() noexcept
+    {
+      auto head = head_.load(std::memory_order_acquire);
+      while (true) {
+        const auto index = static_cast<std::uint32_t>(head);
+        if (index == nil) return {};
+        const auto next = next_[index].load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, tagged(head, next), std::memory_order_acquire, std::memory_order_acquire)) {
+          return {this, index};
+        }
+      }
+    }
+
+  private:
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+
+    /// The head of the free list is an index in the low half, and a tag incremented on every
+    /// change in the high half, so a stale compare-exchange can't succeed (ABA).
+    static std::uint64_t tagged(std::uint64_t head, std::uint32_t index) noexcept
+    {
+      return ((head >> 32) + 1) << 32 | index;
+    }
+
+    void release(std::uint32_t index) noexcept
+    {
+      reset(instances_[index]);
+      auto head = head_.load(std::memory_order_relaxed);
+      do {
+        next_[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+      } while (!head_.compare_exchange_weak(head, tagged(head, index), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    std::vector<Evaluator> instances_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> next_;
+    alignas(64) std::atomic<std::uint64_t> head_ = nil;
+  };
+
+  /// Make a pool of `size` evaluators of `b`
+  template<AnyBlockRef T>
+  auto make_evaluator_pool(T&& b, std::size_t size)
+  {
+    return EvaluatorPool<evaluator<std::remove_cvref_t<T>>>(make_evaluator(b), size);
+  }
+
+} // namespace eda
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <bit>
+#include <utility>
+
 #include <eda/block.hpp>
 #include <eda/evaluator.hpp>
+#include <eda/fir_design.hpp>
 
 namespace eda {
   /// Halfband FIR filter
@@ -89,6 +93,14 @@ namespace eda {
     0.000000000000000000f,
   }));
 
+  /// Short halfband filter, for the later stages of an oversampling cascade.
+  /// Kaiser window, transition_width=0.25, -80 dB stopband. 23 taps
+  constexpr FIRFilter halfband_short = design::halfband<{.cutoff = 0.25, .transition_width = 0.25}>();
+
+  /// Shortest halfband filter, for the last stages of an oversampling cascade.
+  /// Kaiser window, transition_width=0.375, -80 dB stopband. 15 taps
+  constexpr FIRFilter halfband_shortest = design::halfband<{.cutoff = 0.25, .transition_width = 0.375}>();
+
   template<std::size_t N>
   requires(N == 2) auto resample_filter()
   {
@@ -101,6 +113,13 @@ namespace eda {
     return quarterband;
   }
 
+  /// Designed for other ratios: passband up to 90% of the original Nyquist frequency, -80 dB stopband
+  template<std::size_t N>
+  requires(N > 1 && N != 2 && N != 4) auto resample_filter()
+  {
+    return design::lowpass<{.cutoff = 0.5 / N, .transition_width = 0.1 / N}>();
+  }
+
   // RESAMPLE //////////////////////////////////////////
 
   template<int N, AnyBlock Block>
@@ -114,10 +133,82 @@ namespace eda {
     return Resample<N, decltype(filter_block)>{{filter_block}};
   }
 
+  /// The inner block runs at `N` times the rate, so its latency is divided by `N`, rounded up.
+  ///
+  /// Unless the latency of the inner block is a multiple of `N`, the output is then early by a fraction
+  /// of a frame. `compensate_latency` delays the inner block by that fraction, so the latency is exact.
+  template<int N, AnyBlock Block>
+  struct block_latency<Resample<N, Block>>
+    : std::integral_constant<std::size_t, (N > 0 ? (latency<Block> + N - 1) / N : latency<Block> * -N)> {};
+
+  template<int N, AnyBlock Block>
+  constexpr auto compensate_latency(const Resample<N, Block>& block) noexcept
+  {
+    auto inner = compensate_latency(std::get<0>(block.operands));
+    if constexpr (N > 0) {
+      auto aligned = detail::delay_outputs<(N - latency<decltype(inner)> % N) % N>(inner);
+      return Resample<N, decltype(aligned)>{{aligned}};
+    } else {
+      return Resample<N, decltype(inner)>{{inner}};
+    }
+  }
+
+  // OVERSAMPLE ////////////////////////////////////////
+
+  /// Default filter for stage `Stage` of an oversampling cascade, the first stage being 0.
+  ///
+  /// Each stage doubles the rate, while the signal stays within the band of the original
+  /// rate, so the transition band gets wider, and the filter shorter, at every stage.
+  template<std::size_t Stage>
+  constexpr auto halfband_stage_filter()
+  {
+    if constexpr (Stage == 0) {
+      return halfband;
+    } else if constexpr (Stage == 1) {
+      return halfband_short;
+    } else {
+      return halfband_shortest;
+    }
+  }
+
+  /// Oversample `block` with a cascade of 2x stages, one per filter.
+  ///
+  /// The first filter is used by the outermost stage, which runs at twice the base rate.
+  /// Each following stage runs at twice the rate of the previous one, so `block` runs at
+  /// `2^sizeof...(Filters)` times the base rate.
+  template<AnyBlock Block, AnyBlock Filter, AnyBlock... Filters>
+  constexpr auto oversample_cascade(Block block, Filter filter, Filters... filters)
+  {
+    if constexpr (sizeof...(Filters) == 0) {
+      return resample<2>(block, filter, filter);
+    } else {
+      return resample<2>(oversample_cascade(block, filters...), filter, filter);
+    }
+  }
+
+  /// Oversample `block` by `Factor`, a power of two, with a cascade of halfband stages.
+  template<std::size_t Factor, AnyBlock Block>
+  requires(Factor >= 2 && std::has_single_bit(Factor)) //
+    constexpr auto oversample(Block block)
+  {
+    return [&]<std::size_t... Stages>(std::index_sequence<Stages...>)
+    {
+      return oversample_cascade(block, halfband_stage_filter<Stages>()...);
+    }
+    (std::make_index_sequence<std::countr_zero(Factor)>());
+  }
+
+  /// Resample `block` by `N` using the default filters.
+  ///
+  /// 8x and 16x are built as a cascade of halfband stages, see `oversample`.
   template<int N>
   constexpr auto resample(AnyBlock auto block)
   {
-    return resample<N>(block, resample_filter<N>(), resample_filter<N>());
+    if constexpr (N == 8 || N == 16) {
+      return oversample<N>(block);
+    } else {
+      return resample<N>(block, resample_filter<N>(), resample_filter<N>());
+    }
   }
 
   template<int N, AnyBlock Block>
@@ -126,6 +217,12 @@ namespace eda {
 
     constexpr evaluator(const Resample<N, Block>& resample) noexcept : EvaluatorBase<Resample<N, Block>>(resample) {}
 
+    /// The inner block is evaluated `N` times per frame, so its smoothed values ramp over `N * n` evaluations
+    constexpr void begin_buffer(std::size_t n)
+    {
+      detail::begin_buffer(std::get<0>(this->operands), n * N);
+    }
+
     constexpr Frame<outs<Block>> eval(Frame<ins<Block>> in)
     {
       // Zero stuffing reduces amplitude by N
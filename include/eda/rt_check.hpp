@@ -0,0 +1,187 @@
+#pragma once
+
+#include <string>
+#include <typeinfo>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/internal/rt_check.hpp"
+
+namespace eda {
+
+  // RT CHECK //////////////////////////////////////////
+
+  /// Calls that are not real-time safe, made during a check. See `RtCheck`.
+  struct RtReport : detail::RtViolations {
+    /// Whether no allocation, deallocation or lock was seen
+    [[nodiscard]] bool ok() const noexcept
+    {
+      return allocations + deallocations + locks == 0;
+    }
+
+    /// Readable name of the block that made the first violation, or an empty string if there was none
+    [[nodiscard]] std::string block_name() const
+    {
+      if (block == nullptr) return {};
+#if __has_include(<cxxabi.h>)
+      int status = 0;
+      char* name = abi::__cxa_demangle(block->name(), nullptr, nullptr, &status);
+      if (status == 0) {
+        std::string res = name;
+        std::free(name);
+        return res;
+      }
+#endif
+      return block->name();
+    }
+  };
+
+  /// Whether allocations and locks are detected, which needs one translation unit of the program to define
+  /// `EDA_RT_CHECK_IMPLEMENTATION` before including this header. Only supported with glibc.
+  [[nodiscard]] inline bool rt_check_supported() noexcept
+  {
+    return detail::rt_check_installed.load(std::memory_order_relaxed);
+  }
+
+  /// Records the allocations, deallocations and mutex locks made by the current thread while it is alive.
+  ///
+  /// `malloc`, `free` and the functions built on them, like `operator new`, count as allocations
+  /// and deallocations, and `pthread_mutex_lock`, like `std::mutex::lock`, counts as a lock.
+  /// Violations are attributed to the innermost block being processed. Blocks are only tracked
+  /// through the buffer processing of compositions when `EDA_RT_CHECK` is defined in every
+  /// translation unit, and otherwise to the block passed to `rt_check_process` or `rt_check_eval`.
+  ///
+  /// Checks don't nest. Meant for tests and debug builds.
+  struct RtCheck {
+    RtCheck() noexcept
+    {
+      detail::rt_check_state.violations = {};
+      detail::rt_check_state.active = true;
+    }
+
+    RtCheck(const RtCheck&) = delete;
+    RtCheck& operator=(const RtCheck&) = delete;
+
+    ~RtCheck()
+    {
+      detail::rt_check_state.active = false;
+    }
+
+    /// The violations so far
+    [[nodiscard]] RtReport report() const noexcept
+    {
+      return {detail::rt_check_state.violations};
+    }
+  };
+
+  /// Process a buffer with `e`, like `process`, and report the calls it made that are not real-time safe
+  template<typename E>
+  RtReport rt_check_process(E& e, BufferView<ins<block_for_t<E>>> in, BufferView<outs<block_for_t<E>>> out)
+  {
+    const RtCheck check;
+    {
+      const detail::RtBlockScope scope(typeid(block_for_t<E>));
+      process(e, in, out);
+    }
+    return check.report();
+  }
+
+  /// Evaluate a frame with `e`, and report the calls it made that are not real-time safe
+  template<typename E>
+  RtReport rt_check_eval(E& e, Frame<ins<block_for_t<E>>> in)
+  {
+    const RtCheck check;
+    {
+      const detail::RtBlockScope scope(typeid(block_for_t<E>));
+      e.eval(in);
+    }
+    return check.report();
+  }
+
+} // namespace eda
+
+// IMPLEMENTATION ////////////////////////////////////
+
+#if defined(EDA_RT_CHECK_IMPLEMENTATION) && defined(__GLIBC__)
+
+#include <atomic>
+#include <cerrno>
+#include <dlfcn.h>
+#include <pthread.h>
+
+// Replaces the allocation functions of the C library for the whole program, forwarding to the glibc
+// allocator, which also serves the functions left alone. `operator new` and `delete` call these.
+extern "C" {
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t n, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size) noexcept
+{
+  eda::detail::rt_check_call(eda::detail::RtCall::allocation);
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t n, std::size_t size) noexcept
+{
+  eda::detail::rt_check_call(eda::detail::RtCall::allocation);
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+  eda::detail::rt_check_call(eda::detail::RtCall::allocation);
+  return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+  eda::detail::rt_check_call(eda::detail::RtCall::allocation);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) noexcept
+{
+  eda::detail::rt_check_call(eda::detail::RtCall::allocation);
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+  void* res = __libc_memalign(alignment, size);
+  if (res == nullptr) return ENOMEM;
+  *ptr = res;
+  return 0;
+}
+
+void free(void* ptr) noexcept
+{
+  if (ptr != nullptr) eda::detail::rt_check_call(eda::detail::RtCall::deallocation);
+  __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+  using lock_fn = int (*)(pthread_mutex_t*);
+  // Resolved on first use, which may be before static initialization
+  static std::atomic<lock_fn> next = nullptr;
+  auto fn = next.load(std::memory_order_relaxed);
+  if (fn == nullptr) {
+    fn = reinterpret_cast<lock_fn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    next.store(fn, std::memory_order_relaxed);
+  }
+  eda::detail::rt_check_call(eda::detail::RtCall::lock);
+  return fn(mutex);
+}
+
+} // extern "C"
+
+namespace eda::detail {
+  [[maybe_unused]] static const bool rt_check_installer = (rt_check_installed.store(true), true);
+} // namespace eda::detail
+
+#endif
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+
+namespace eda {
+
+  // SIMULATED HOST ////////////////////////////////////
+
+  struct HostOptions {
+    double sample_rate = 48000;
+    /// Frames per callback
+    std::size_t buffer_size = 128;
+    /// Number of callbacks to run
+    std::size_t callbacks = 1000;
+    /// Run the audio thread with `SCHED_FIFO` at this priority, when permitted. 0 keeps the default scheduling
+    int realtime_priority = 80;
+    /// Number of histogram bins, spanning from 0 to twice the deadline
+    std::size_t histogram_bins = 100;
+  };
+
+  /// Timing statistics of a simulated host run, see `simulate_host`
+  struct HostStats {
+    using duration = std::chrono::nanoseconds;
+
+    /// Time between two callbacks, within which each must be done
+    duration deadline = duration::zero();
+    std::size_t callbacks = 0;
+    /// Callbacks which finished after their deadline, one period after they were due
+    std::size_t xruns = 0;
+    /// Whether the audio thread got real-time scheduling
+    bool realtime = false;
+
+    /// Longest processing time of a callback
+    duration worst = duration::zero();
+    /// Sum of the processing times of all callbacks
+    duration total = duration::zero();
+    /// Longest delay between the time a callback was due and the time it started
+    duration worst_jitter = duration::zero();
+
+    /// `histogram[i]` counts the callbacks which took between `i` and `i + 1` times `bin_width()`.
+    /// The last bin also counts all longer callbacks.
+    std::vector<std::uint64_t> histogram;
+
+    [[nodiscard]] duration bin_width() const noexcept
+    {
+      return histogram.empty() ? duration::zero() : 2 * deadline / static_cast<duration::rep>(histogram.size());
+    }
+
+    [[nodiscard]] duration mean() const noexcept
+    {
+      return callbacks == 0 ? duration::zero() : total / static_cast<duration::rep>(callbacks);
+    }
+
+    /// Worst processing time, in percent of the deadline
+    [[nodiscard]] double worst_load() const noexcept
+    {
+      return percent(worst);
+    }
+
+    /// Mean processing time, in percent of the deadline
+    [[nodiscard]] double mean_load() const noexcept
+    {
+      return percent(mean());
+    }
+
+    /// Add a callback which started `jitter` after it was due, and took `elapsed`
+    void record(duration elapsed, duration jitter) noexcept
+    {
+      callbacks++;
+      total += elapsed;
+      worst = std::max(worst, elapsed);
+      worst_jitter = std::max(worst_jitter, jitter);
+      if (jitter + elapsed > deadline) xruns++;
+      if (histogram.empty()) return;
+      const auto bin = static_cast<std::size_t>(elapsed / bin_width());
+      histogram[std::min(bin, histogram.size() - 1)]++;
+    }
+
+    /// Write the histogram as CSV, one bin per line, with its lower bound in nanoseconds and in percent of the deadline
+    void write_csv(std::ostream& os) const
+    {
+      os << "start_ns,load_percent,count\n";
+      for (std::size_t i = 0; i < histogram.size(); i++) {
+        const auto start = bin_width() * i;
+        os << start.count() << ',' << percent(start) << ',' << histogram[i] << '\n';
+      }
+    }
+
+    /// Write the statistics as a JSON object, with durations in nanoseconds
+    void write_json(std::ostream& os) const
+    {
+      os << "{\"deadline_ns\": " << deadline.count() << ", \"callbacks\": " << callbacks << ", \"xruns\": " << xruns
+         << ", \"realtime\": " << (realtime ? "true" : "false") << ", \"worst_ns\": " << worst.count()
+         << ", \"mean_ns\": " << mean().count() << ", \"worst_load_percent\": " << worst_load()
+         << ", \"mean_load_percent\": " << mean_load() << ", \"worst_jitter_ns\": " << worst_jitter.count()
+         << ", \"bin_width_ns\": " << bin_width().count() << ", \"histogram\": [";
+      for (std::size_t i = 0; i < histogram.size(); i++) os << (i == 0 ? "" : ", ") << histogram[i];
+      os << "]}\n";
+    }
+
+  private:
+    [[nodiscard]] double percent(duration d) const noexcept
+    {
+      return deadline.count() == 0 ? 0. : 100. * d.count() / deadline.count();
+    }
+  };
+
+  namespace detail {
+    /// Best-effort, as real-time scheduling needs privileges that CI machines and containers often lack
+    inline bool set_realtime_priority(int priority) noexcept
+    {
+#ifdef __linux__
+      if (priority <= 0) return false;
+      sched_param param = {};
+      param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+      return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#else
+      return false;
+#endif
+    }
+  } // namespace detail
+
+  /// Run `block` the way an audio host would, and measure whether it keeps up.
+  ///
+  /// A new thread evaluates the block one buffer of `options.buffer_size` frames at a time, woken up
+  /// every `buffer_size / sample_rate` seconds, which is also the deadline of each callback. Inputs
+  /// are low level noise, so blocks don't skip work on silence. A callback that overruns its deadline
+  /// is an xrun: like a real host, the next callback is then due as soon as it ends, and the following
+  /// ones are paced from there rather than run back to back to catch up. Blocks until all callbacks have run.
+  template<AnyBlock Block>
+  HostStats simulate_host(const Block& block, const HostOptions& options = {})
+  {
+    using clock = std::chrono::steady_clock;
+    HostStats stats;
+    stats.deadline = std::chrono::round<HostStats::duration>(
+      std::chrono::duration<double>(static_cast<double>(options.buffer_size) / options.sample_rate));
+    stats.histogram.assign(options.histogram_bins, 0);
+
+    std::thread audio([&] {
+      stats.realtime = detail::set_realtime_priority(options.realtime_priority);
+      // Everything is allocated before the first callback
+      auto e = make_evaluator(block);
+      AudioBuffer<ins<Block>> in(options.buffer_size);
+      AudioBuffer<outs<Block>> out(options.buffer_size);
+      std::uint32_t seed = 1;
+      auto next = clock::now() + stats.deadline;
+      for (std::size_t cb = 0; cb < options.callbacks; cb++) {
+        for (std::size_t c = 0; c < ins<Block>; c++) {
+          for (std::size_t i = 0; i < options.buffer_size; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            in[c][i] = 1e-3f * (static_cast<float>(seed >> 8) / (1u << 24) - 0.5f);
+          }
+        }
+        std::this_thread::sleep_until(next);
+        const auto start = clock::now();
+        process(e, in.view(), out.view());
+        const auto end = clock::now();
+        stats.record(end - start, std::max(start - next, clock::duration::zero()));
+        next = end > next + stats.deadline ? end : next + stats.deadline;
+      }
+    });
+    audio.join();
+    return stats;
+  }
+
+} // namespace eda
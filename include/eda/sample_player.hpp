@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "eda/block.hpp"
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/storage.hpp"
+
+namespace eda {
+
+  // MAPPED SAMPLES ////////////////////////////////////
+
+  /// Read-only memory mapping of mono samples stored as `Storage`, in a file.
+  ///
+  /// Opening a file maps it without reading it, so it takes the same time whatever its size,
+  /// and only the pages that are read take up memory. The pages can be evicted again by the
+  /// kernel, as they are backed by the file. Uses POSIX `mmap`.
+  template<ASampleStorage Storage = storage::f32>
+  struct MappedSamples {
+    using value_type = typename Storage::value_type;
+
+    /// Bytes read ahead of the playback position, see `will_need`
+    static constexpr std::size_t read_ahead_bytes = std::size_t(1) << 18;
+
+    MappedSamples(const MappedSamples&) = delete;
+    MappedSamples& operator=(const MappedSamples&) = delete;
+
+    ~MappedSamples()
+    {
+      if (base_ != nullptr) ::munmap(base_, length_);
+    }
+
+    /// Map the headerless file at `path`, where samples start at byte `offset`.
+    ///
+    /// Returns null if the file can't be mapped, or if `offset` is not aligned for `value_type`.
+    static std::shared_ptr<const MappedSamples> open_raw(const char* path, std::size_t offset = 0)
+    {
+      auto res = map(path);
+      if (!res || !res->set_range(offset, res->length_)) return nullptr;
+      return res;
+    }
+
+    /// Map the samples of a mono WAV file.
+    ///
+    /// Returns null if the file can't be mapped, or if its format does not match `Storage`:
+    /// 32 bit float for `storage::f32`, and 16 or 24 bit PCM for `storage::i16` and `storage::i24`.
+    static std::shared_ptr<const MappedSamples> open_wav(const char* path)
+    {
+      auto res = map(path);
+      if (!res) return nullptr;
+      const auto* bytes = static_cast<const std::uint8_t*>(res->base_);
+      const auto length = res->length_;
+      if (length < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) return nullptr;
+      bool format_ok = false;
+      for (std::size_t pos = 12; pos + 8 <= length;) {
+        const std::size_t size = read_le(bytes + pos + 4, 4);
+        const auto* body = bytes + pos + 8;
+        if (std::memcmp(bytes + pos, "fmt ", 4) == 0 && size >= 16 && pos + 8 + 16 <= length) {
+          const auto format = read_le(body, 2);
+          const auto channels = read_le(body + 2, 2);
+          const auto bits = read_le(body + 14, 2);
+          format_ok = channels == 1 && matches_format(format, bits);
+        } else if (std::memcmp(bytes + pos, "data", 4) == 0) {
+          if (!format_ok || !res->set_range(pos + 8, std::min(length, pos + 8 + size))) return nullptr;
+          return res;
+        }
+        // Chunks are padded to an even size
+        pos += 8 + size + (size & 1);
+      }
+      return nullptr;
+    }
+
+    /// Number of samples
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    [[nodiscard]] const value_type* data() const noexcept
+    {
+      return data_;
+    }
+
+    [[nodiscard]] float operator[](std::size_t i) const noexcept
+    {
+      return Storage::decode(data_[i]);
+    }
+
+    /// Ask the kernel to start reading the pages of samples `[begin; begin + n[` in the background
+    void will_need(std::size_t begin, std::size_t n) const noexcept
+    {
+      if (begin >= size_) return;
+      n = std::min(n, size_ - begin);
+      const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+      const auto first = reinterpret_cast<std::uintptr_t>(data_ + begin) / page * page;
+      const auto last = reinterpret_cast<std::uintptr_t>(data_ + begin + n);
+      ::madvise(reinterpret_cast<void*>(first), last - first, MADV_WILLNEED);
+    }
+
+  private:
+    MappedSamples(void* base, std::size_t length) noexcept : base_(base), length_(length) {}
+
+    /// Map the whole file, without any samples yet
+    static std::shared_ptr<MappedSamples> map(const char* path)
+    {
+      const int fd = ::open(path, O_RDONLY);
+      if (fd < 0) return nullptr;
+      struct stat st = {};
+      void* base = MAP_FAILED;
+      if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+      }
+      // The mapping keeps the file open
+      ::close(fd);
+      if (base == MAP_FAILED) return nullptr;
+      return std::shared_ptr<MappedSamples>(new MappedSamples(base, static_cast<std::size_t>(st.st_size)));
+    }
+
+    /// Use bytes `[begin; end[` of the file as samples, and start reading them in
+    bool set_range(std::size_t begin, std::size_t end) noexcept
+    {
+      if (begin % alignof(value_type) != 0 || begin > end) return false;
+      data_ = reinterpret_cast<const value_type*>(static_cast<const std::uint8_t*>(base_) + begin);
+      size_ = (end - begin) / sizeof(value_type);
+      will_need(0, read_ahead_bytes / sizeof(value_type));
+      return true;
+    }
+
+    static std::uint32_t read_le(const std::uint8_t* p, std::size_t n) noexcept
+    {
+      std::uint32_t res = 0;
+      for (std::size_t i = 0; i < n; i++) res |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+      return res;
+    }
+
+    static bool matches_format(std::uint32_t format, std::uint32_t bits) noexcept
+    {
+      constexpr std::uint32_t pcm = 1;
+      constexpr std::uint32_t ieee_float = 3;
+      if constexpr (std::same_as<Storage, storage::f32>) return format == ieee_float && bits == 32;
+      if constexpr (std::same_as<Storage, storage::i16>) return format == pcm && bits == 16;
+      if constexpr (std::same_as<Storage, storage::i24>) return format == pcm && bits == 24;
+      return false;
+    }
+
+    void* base_ = nullptr;
+    std::size_t length_ = 0;
+    const value_type* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+
+  // SAMPLE PLAYER /////////////////////////////////////
+
+  /// Plays back mapped samples.
+  ///
+  /// Given input signals `(trigger, rate)`, restarts playback from the first sample whenever
+  /// `trigger` rises above 0, and advances by `rate` samples every frame, reading between
+  /// samples with linear interpolation. Outputs 0 until the first trigger, and once playback
+  /// is past the last sample.
+  template<ASampleStorage Storage = storage::f32>
+  struct SamplePlayer : BlockBase<SamplePlayer<Storage>, 2, 1> {
+    std::shared_ptr<const MappedSamples<Storage>> samples;
+  };
+
+  template<ASampleStorage Storage>
+  SamplePlayer<Storage> sample_player(std::shared_ptr<const MappedSamples<Storage>> samples) noexcept
+  {
+    return {{}, std::move(samples)};
+  }
+
+  template<ASampleStorage Storage>
+  struct evaluator<SamplePlayer<Storage>> : EvaluatorBase<SamplePlayer<Storage>> {
+    /// Number of decoded samples a chunk may span, which allows rates up to 3
+    static constexpr std::size_t max_span = 3 * process_chunk + 2;
+
+    evaluator(const SamplePlayer<Storage>& p) : samples_(p.samples) {}
+
+    Frame<1> eval(Frame<2> in)
+    {
+      trigger(in[0]);
+      const float res = read(position_);
+      position_ += in[1];
+      read_ahead();
+      return res;
+    }
+
+    /// Decodes the samples spanned by each chunk at once, before interpolating between them
+    void process(BufferView<2> in, BufferView<1> out)
+    {
+      std::array<double, process_chunk> positions;
+      std::array<float, max_span> decoded;
+      for (std::size_t i = 0; i < in.size(); i += process_chunk) {
+        const auto n = std::min(process_chunk, in.size() - i);
+        for (std::size_t k = 0; k < n; k++) {
+          trigger(in[0][i + k]);
+          positions[k] = position_;
+          position_ += in[1][i + k];
+        }
+        const auto [lo, hi] = std::minmax_element(positions.begin(), positions.begin() + n);
+        const double size = samples_ ? static_cast<double>(samples_->size()) : 0;
+        if (!(*lo >= 0 && *hi + 1 < size && *hi - *lo + 2 < max_span)) {
+          // Partly outside of the samples, or too far apart to decode at once
+          for (std::size_t k = 0; k < n; k++) out[0][i + k] = read(positions[k]);
+        } else {
+          const auto first = static_cast<std::size_t>(*lo);
+          const auto last = static_cast<std::size_t>(*hi) + 1;
+          codec_.decode(samples_->data() + first, decoded.data(), last - first + 1);
+          for (std::size_t k = 0; k < n; k++) {
+            const double p = positions[k] - static_cast<double>(first);
+            const auto idx = static_cast<std::size_t>(p);
+            const auto frac = static_cast<float>(p - idx);
+            out[0][i + k] = decoded[idx] + frac * (decoded[idx + 1] - decoded[idx]);
+          }
+        }
+        read_ahead();
+      }
+    }
+
+    void reset() noexcept
+    {
+      position_ = stopped;
+      gate_ = false;
+      advised_ = 0;
+    }
+
+    /// Once playback is past the end, or before it has started
+    bool quiescent() const noexcept
+    {
+      return !samples_ || position_ < 0 || position_ >= samples_->size();
+    }
+
+  private:
+    static constexpr double stopped = std::numeric_limits<double>::infinity();
+    static constexpr std::size_t read_ahead_samples =
+      MappedSamples<Storage>::read_ahead_bytes / sizeof(typename Storage::value_type);
+
+    void trigger(float t) noexcept
+    {
+      if (t > 0 && !gate_) {
+        position_ = 0;
+        advised_ = 0;
+      }
+      gate_ = t > 0;
+    }
+
+    float read(double p) const noexcept
+    {
+      if (!samples_ || !(p >= 0) || p + 1 >= samples_->size()) return 0;
+      const auto idx = static_cast<std::size_t>(p);
+      const auto frac = static_cast<float>(p - idx);
+      const float a = (*samples_)[idx];
+      return a + frac * ((*samples_)[idx + 1] - a);
+    }
+
+    /// Keep at least half of the read ahead window in front of the playback position
+    void read_ahead() noexcept
+    {
+      if (!samples_ || !(position_ >= 0) || position_ >= samples_->size()) return;
+      const auto pos = static_cast<std::size_t>(position_);
+      if (pos + read_ahead_samples / 2 < advised_) return;
+      samples_->will_need(pos, read_ahead_samples);
+      advised_ = pos + read_ahead_samples;
+    }
+
+    std::shared_ptr<const MappedSamples<Storage>> samples_;
+    [[no_unique_address]] storage::Codec<Storage> codec_;
+    double position_ = stopped;
+    /// Samples up to which reading ahead has been requested
+    std::size_t advised_ = 0;
+    bool gate_ = false;
+  };
+
+} // namespace eda
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <numbers>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "eda/block.hpp"
+#include "eda/buffer.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/internal/fft.hpp"
+#include "eda/internal/util.hpp"
+
+namespace eda {
+
+  // STFT PLAN /////////////////////////////////////////
+
+  /// Tables for the analysis and resynthesis of `FFTSize` sample frames every `Hop` samples.
+  ///
+  /// Frames are windowed with the square root of a periodic Hann window both before and after
+  /// the spectral processing, which add up to a constant when overlapped every `Hop` samples.
+  /// Immutable, and shared by all evaluators of a block.
+  template<std::size_t FFTSize, std::size_t Hop>
+  struct StftPlan {
+    static_assert(std::has_single_bit(FFTSize) && FFTSize >= 4, "FFTSize must be a power of two");
+    static_assert(FFTSize % Hop == 0 && Hop <= FFTSize / 2, "Frames must overlap by a whole number of hops");
+
+    StftPlan() : fft(std::make_shared<const util::FFTPlan>(FFTSize)), analysis(FFTSize), synthesis(FFTSize)
+    {
+      // The overlapped windows add up to `FFTSize / (2 * Hop)`, and the inverse transform scales by `FFTSize`
+      const double scale = 2. * Hop / FFTSize / FFTSize;
+      for (std::size_t i = 0; i < FFTSize; i++) {
+        const double w = std::sin(std::numbers::pi * i / FFTSize);
+        analysis[i] = static_cast<float>(w);
+        synthesis[i] = static_cast<float>(w * scale);
+      }
+    }
+
+    std::shared_ptr<const util::FFTPlan> fft;
+    std::vector<float> analysis;
+    /// Includes the normalization of the overlap-add and of the inverse transform
+    std::vector<float> synthesis;
+  };
+
+  // STFT //////////////////////////////////////////////
+
+  /// Processes its input in the frequency domain, with a short-time Fourier transform.
+  ///
+  /// Every `Hop` samples, the last `FFTSize` samples of input are windowed and transformed, and `func` is
+  /// called with the real and imaginary parts of the `FFTSize / 2 + 1` bins of the spectrum, which it modifies
+  /// in place. The spectra are transformed back and overlap-added into the output, `FFTSize` samples later.
+  /// Like stateful `fun` blocks, `func` is also given references to the `states` of the evaluator.
+  template<std::size_t FFTSize, std::size_t Hop, typename Func, typename... States>
+  requires(util::Callable<Func, void(std::span<float>, std::span<float>, States&...)>&& std::copyable<Func>) &&
+    (std::copyable<States> && ...) //
+    struct Stft : BlockBase<Stft<FFTSize, Hop, Func, States...>, 1, 1> {
+    Func func;
+    std::tuple<States...> states;
+    std::shared_ptr<const StftPlan<FFTSize, Hop>> plan;
+  };
+
+  template<std::size_t FFTSize, std::size_t Hop = FFTSize / 4, typename... States>
+  auto stft(util::Callable<void(std::span<float>, std::span<float>, std::remove_cvref_t<States>&...)> auto&& f,
+            States&&... states)
+  {
+    return Stft<FFTSize, Hop, std::decay_t<decltype(f)>, std::remove_cvref_t<States>...>{
+      .func = f,
+      .states = {FWD(states)...},
+      .plan = std::make_shared<const StftPlan<FFTSize, Hop>>(),
+    };
+  }
+
+  template<std::size_t FFTSize, std::size_t Hop, typename Func, typename... States>
+  struct block_latency<Stft<FFTSize, Hop, Func, States...>> : std::integral_constant<std::size_t, FFTSize> {};
+
+  template<std::size_t FFTSize, std::size_t Hop, typename Func, typename... States>
+  struct evaluator<Stft<FFTSize, Hop, Func, States...>> : EvaluatorBase<Stft<FFTSize, Hop, Func, States...>> {
+    static constexpr std::size_t bins = FFTSize / 2 + 1;
+
+    evaluator(const Stft<FFTSize, Hop, Func, States...>& s)
+      : func_(s.func),
+        initial_states_(s.states),
+        states_(s.states),
+        plan_(s.plan),
+        fft_(plan_->fft),
+        input_(FFTSize),
+        frame_(FFTSize),
+        sum_(FFTSize),
+        output_(Hop),
+        re_(bins),
+        im_(bins)
+    {}
+
+    Frame<1> eval(Frame<1> in)
+    {
+      const float res = output_[fill_];
+      input_[FFTSize - Hop + fill_] = in[0];
+      if (++fill_ == Hop) hop();
+      return res;
+    }
+
+    /// Copies whole runs of the buffer at once, up to the next hop. `in` and `out` may be the same buffer
+    void process(BufferView<1> in, BufferView<1> out)
+    {
+      for (std::size_t i = 0; i < in.size();) {
+        const auto n = std::min(Hop - fill_, in.size() - i);
+        std::copy_n(in[0] + i, n, input_.data() + FFTSize - Hop + fill_);
+        std::copy_n(output_.data() + fill_, n, out[0] + i);
+        fill_ += n;
+        i += n;
+        if (fill_ == Hop) hop();
+      }
+    }
+
+    void reset()
+    {
+      states_ = initial_states_;
+      std::ranges::fill(input_, 0.f);
+      std::ranges::fill(sum_, 0.f);
+      std::ranges::fill(output_, 0.f);
+      fill_ = 0;
+    }
+
+  private:
+    /// Analyse the last frame of input, process its spectrum, and add it back into the output
+    void hop()
+    {
+      const auto& plan = *plan_;
+      for (std::size_t i = 0; i < FFTSize; i++) frame_[i] = input_[i] * plan.analysis[i];
+      fft_.forward(frame_.data(), re_.data(), im_.data());
+      std::apply([&](States&... st) { func_(std::span<float>(re_), std::span<float>(im_), st...); }, states_);
+      fft_.inverse(re_.data(), im_.data(), frame_.data());
+      for (std::size_t i = 0; i < FFTSize; i++) sum_[i] += frame_[i] * plan.synthesis[i];
+      // The first hop of the sum has had all the frames it overlaps with added
+      std::copy_n(sum_.begin(), Hop, output_.begin());
+      std::shift_left(sum_.begin(), sum_.end(), Hop);
+      std::fill_n(sum_.end() - Hop, Hop, 0.f);
+      std::shift_left(input_.begin(), input_.end(), Hop);
+      fill_ = 0;
+    }
+
+    Func func_;
+    std::tuple<States...> initial_states_;
+    std::tuple<States...> states_;
+    std::shared_ptr<const StftPlan<FFTSize, Hop>> plan_;
+    util::RealFFT fft_;
+    /// The last `FFTSize` samples of input, of which the last hop is being collected
+    std::vector<float> input_;
+    /// The frame being transformed
+    std::vector<float> frame_;
+    /// Overlap-add of the resynthesized frames
+    std::vector<float> sum_;
+    /// The hop of output being played back
+    std::vector<float> output_;
+    std::vector<float> re_;
+    std::vector<float> im_;
+    /// Samples collected in the current hop
+    std::size_t fill_ = 0;
+  };
+
+} // namespace eda
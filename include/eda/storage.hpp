@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "eda/internal/cpu.hpp"
+
+namespace eda {
+
+  // SAMPLE STORAGE ////////////////////////////////////
+
+  /// A format for storing samples in long delay lines.
+  ///
+  /// Provides the stored `value_type`, and conversions to and from `float`.
+  template<typename T>
+  concept ASampleStorage = std::is_trivially_copyable_v<typename T::value_type> && requires(float f, typename T::value_type v)
+  {
+    { T::encode(f) } -> std::same_as<typename T::value_type>;
+    { T::decode(v) } -> std::same_as<float>;
+  };
+
+  namespace storage {
+
+    /// Full precision 32 bit float storage. The default.
+    struct f32 {
+      using value_type = float;
+      static constexpr value_type encode(float f) noexcept
+      {
+        return f;
+      }
+      static constexpr float decode(value_type v) noexcept
+      {
+        return v;
+      }
+    };
+
+    /// IEEE 754 half precision float storage. Half the size of `f32`.
+    ///
+    /// Keeps 11 significant bits, so the relative error is at most 2^-11 (about -66 dB
+    /// relative to the signal). Values above 65504 in magnitude become infinite, and values
+    /// below 2^-24 are flushed to zero.
+    struct f16 {
+      using value_type = std::uint16_t;
+
+      static constexpr value_type encode(float f) noexcept
+      {
+        const auto x = std::bit_cast<std::uint32_t>(f);
+        const std::uint32_t sign = (x >> 16) & 0x8000;
+        const std::uint32_t f_exp = (x >> 23) & 0xff;
+        std::uint32_t mant = x & 0x007fffff;
+        const int exp = static_cast<int>(f_exp) - 127 + 15;
+        if (f_exp == 0xff) return sign | 0x7c00 | (mant != 0 ? 0x200 : 0);
+        if (exp >= 31) return sign | 0x7c00;
+        if (exp <= 0) {
+          if (exp < -10) return sign;
+          // Subnormal half, round to nearest even
+          mant |= 0x00800000;
+          const auto shift = static_cast<std::uint32_t>(14 - exp);
+          std::uint32_t h = mant >> shift;
+          const std::uint32_t rem = mant & ((1u << shift) - 1);
+          const std::uint32_t halfway = 1u << (shift - 1);
+          if (rem > halfway || (rem == halfway && (h & 1) != 0)) h++;
+          return sign | h;
+        }
+        std::uint32_t h = sign | (static_cast<std::uint32_t>(exp) << 10) | (mant >> 13);
+        // Round to nearest even. A carry into the exponent is correct, and may produce infinity.
+        const std::uint32_t rem = mant & 0x1fff;
+        if (rem > 0x1000 || (rem == 0x1000 && (h & 1) != 0)) h++;
+        return static_cast<value_type>(h);
+      }
+
+      static constexpr float decode(value_type h) noexcept
+      {
+        const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+        const std::uint32_t exp = (h >> 10) & 0x1f;
+        const std::uint32_t mant = h & 0x3ff;
+        if (exp == 0) {
+          const float v = static_cast<float>(mant) * 0x1p-24f;
+          return sign != 0 ? -v : v;
+        }
+        if (exp == 31) return std::bit_cast<float>(sign | 0x7f800000 | (mant << 13));
+        return std::bit_cast<float>(sign | ((exp + 112) << 23) | (mant << 13));
+      }
+    };
+
+    /// 16 bit fixed point storage. Half the size of `f32`.
+    ///
+    /// Values are clipped to [-1; 1], and quantized with a step of 1/32767, so the
+    /// noise floor is about -96 dBFS.
+    struct i16 {
+      using value_type = std::int16_t;
+      static constexpr float scale = 32767.f;
+
+      static constexpr value_type encode(float f) noexcept
+      {
+        const float v = std::clamp(f, -1.f, 1.f) * scale;
+        return static_cast<value_type>(v + (v >= 0 ? 0.5f : -0.5f));
+      }
+      static constexpr float decode(value_type v) noexcept
+      {
+        return static_cast<float>(v) * (1.f / scale);
+      }
+    };
+
+    /// 24 bit fixed point storage, packed in 3 bytes. Three quarters the size of `f32`.
+    ///
+    /// Values are clipped to [-1; 1], and quantized with a step of 1/8388607, so the
+    /// noise floor is about -144 dBFS.
+    struct i24 {
+      struct value_type {
+        std::array<std::uint8_t, 3> bytes;
+      };
+      static constexpr float scale = 8388607.f;
+
+      static constexpr value_type encode(float f) noexcept
+      {
+        const float v = std::clamp(f, -1.f, 1.f) * scale;
+        const auto i = static_cast<std::uint32_t>(static_cast<std::int32_t>(v + (v >= 0 ? 0.5f : -0.5f)));
+        return {{static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i >> 8), static_cast<std::uint8_t>(i >> 16)}};
+      }
+      static constexpr float decode(value_type v) noexcept
+      {
+        const auto u = static_cast<std::uint32_t>(v.bytes[0]) | (static_cast<std::uint32_t>(v.bytes[1]) << 8) |
+                       (static_cast<std::uint32_t>(v.bytes[2]) << 16);
+        // Sign extend from 24 bits
+        const auto i = static_cast<std::int32_t>(u << 8) >> 8;
+        return static_cast<float>(i) * (1.f / scale);
+      }
+    };
+    static_assert(sizeof(i24::value_type) == 3);
+
+    /// Encode `n` samples, in a loop written to be vectorized by the compiler
+    template<ASampleStorage S>
+    void encode_generic(const float* in, typename S::value_type* out, std::size_t n) noexcept
+    {
+      for (std::size_t i = 0; i < n; i++) out[i] = S::encode(in[i]);
+    }
+
+    /// Decode `n` samples, in a loop written to be vectorized by the compiler
+    template<ASampleStorage S>
+    void decode_generic(const typename S::value_type* in, float* out, std::size_t n) noexcept
+    {
+      for (std::size_t i = 0; i < n; i++) out[i] = S::decode(in[i]);
+    }
+
+#if EDA_X86_DISPATCH
+    /// `encode_generic<f16>` with F16C, 8 samples at a time
+    EDA_TARGET_AVX2 inline void encode_f16c(const float* in, std::uint16_t* out, std::size_t n) noexcept
+    {
+      std::size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        auto h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+      }
+      for (; i < n; i++) out[i] = f16::encode(in[i]);
+    }
+
+    /// `decode_generic<f16>` with F16C, 8 samples at a time
+    EDA_TARGET_AVX2 inline void decode_f16c(const std::uint16_t* in, float* out, std::size_t n) noexcept
+    {
+      std::size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+      }
+      for (; i < n; i++) out[i] = f16::decode(in[i]);
+    }
+#endif
+
+    /// Converts buffers of samples to and from `S`, with kernels selected for the CPU when it is made.
+    ///
+    /// Evaluators hold one, so the CPU is checked once rather than on every buffer, like `Mix`.
+    /// Formats without kernels for specific instruction sets always use the generic loops, and
+    /// their codec is empty.
+    template<ASampleStorage S>
+    struct Codec {
+      constexpr Codec() noexcept = default;
+
+      void encode(const float* in, typename S::value_type* out, std::size_t n) const noexcept
+      {
+        encode_generic<S>(in, out, n);
+      }
+
+      void decode(const typename S::value_type* in, float* out, std::size_t n) const noexcept
+      {
+        decode_generic<S>(in, out, n);
+      }
+    };
+
+    template<>
+    struct Codec<f16> {
+      using encode_kernel = void (*)(const float*, std::uint16_t*, std::size_t) noexcept;
+      using decode_kernel = void (*)(const std::uint16_t*, float*, std::size_t) noexcept;
+
+      static constexpr util::Multiversioned<encode_kernel> encode_kernels = {
+        .generic = &encode_generic<f16>,
+#if EDA_X86_DISPATCH
+        .avx2 = &encode_f16c,
+#endif
+      };
+      static constexpr util::Multiversioned<decode_kernel> decode_kernels = {
+        .generic = &decode_generic<f16>,
+#if EDA_X86_DISPATCH
+        .avx2 = &decode_f16c,
+#endif
+      };
+
+      constexpr Codec() noexcept
+      {
+        if (!std::is_constant_evaluated()) {
+          encode_ = encode_kernels.select();
+          decode_ = decode_kernels.select();
+        }
+      }
+
+      void encode(const float* in, std::uint16_t* out, std::size_t n) const noexcept
+      {
+        encode_(in, out, n);
+      }
+
+      void decode(const std::uint16_t* in, float* out, std::size_t n) const noexcept
+      {
+        decode_(in, out, n);
+      }
+
+    private:
+      encode_kernel encode_ = encode_kernels.generic;
+      decode_kernel decode_ = decode_kernels.generic;
+    };
+
+    /// Encode `n` samples with the kernel for the CPU. Checks the CPU on every call, so evaluators hold a `Codec` instead.
+    template<ASampleStorage S>
+    void encode(const float* in, typename S::value_type* out, std::size_t n) noexcept
+    {
+      Codec<S>().encode(in, out, n);
+    }
+
+    /// Decode `n` samples with the kernel for the CPU. Checks the CPU on every call, so evaluators hold a `Codec` instead.
+    template<ASampleStorage S>
+    void decode(const typename S::value_type* in, float* out, std::size_t n) noexcept
+    {
+      Codec<S>().decode(in, out, n);
+    }
+
+  } // namespace storage
+
+} // namespace eda
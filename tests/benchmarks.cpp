@@ -1,11 +1,15 @@
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <random>
 #include <ranges>
 
 #include <catch2/catch_all.hpp>
 
+#include "eda/convolution.hpp"
+#include "eda/engine.hpp"
 #include "eda/evaluator.hpp"
+#include "eda/mix.hpp"
 #include "eda/syntax.hpp"
 
 struct Filter {
@@ -126,3 +130,202 @@ TEST_CASE ("Echo benchmark Handwritten C++") {
                  return process;
                }()));
 }
+
+TEST_CASE ("Engine benchmark") {
+  using namespace eda;
+  using namespace eda::syntax;
+  constexpr std::size_t instances = 256;
+  constexpr std::size_t buffer_size = 128;
+  constexpr double sample_rate = 48000;
+
+  float time_samples = 4800;
+  float filter_a = 0.9;
+  float feedback = 0.5;
+  float dry_wet_mix = 0.5;
+  ABlock<2, 1> auto const filter = (_ << (_, _), _) | (((_ * _, (1 - _) * _) | plus) % _);
+  ABlock<1, 1> auto const echo = (plus | delay(ref(time_samples))) % (filter(ref(filter_a)) * ref(feedback));
+  ABlock<1, 1> auto const process = _ << (echo * ref(dry_wet_mix)) + (_ * (1 - ref(dry_wet_mix)));
+
+  Engine<std::remove_cvref_t<decltype(process)>> engine(process, instances, {.buffer_size = buffer_size});
+  for (std::size_t i = 0; i < engine.size(); i++) {
+    auto in = engine.input(i);
+    std::span<float> data(in[0], in.size());
+    fill_random(data);
+  }
+
+  int iterations = 100;
+  using clock = std::chrono::high_resolution_clock;
+  const auto start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    engine.tick();
+  }
+  const auto tick_time = std::chrono::duration<double>(clock::now() - start) / iterations;
+  const auto period = std::chrono::duration<double>(buffer_size / sample_rate);
+  const auto per_core = instances * (period / tick_time) / engine.threads();
+  std::cout << "Engine, " << instances << " echo instances, " << engine.threads() << " threads, buffer size "
+            << buffer_size << ", average tick: " << std::chrono::duration_cast<std::chrono::nanoseconds>(tick_time).count()
+            << "ns, real-time instances/core: " << per_core << "\n";
+}
+
+TEST_CASE ("Linear recurrence benchmark") {
+  using namespace eda;
+  using namespace eda::syntax;
+  float a = 0.9;
+  ABlock<1, 1> auto const filter = ((_ * ref(a), (1 - ref(a)) * _) | plus) % _;
+
+  std::array<float, 1024> in = {};
+  fill_random(in);
+  std::array<float, 1024> out = {};
+  auto frames = make_evaluator(filter);
+  auto buffers = make_evaluator(filter);
+
+  int iterations = 1000;
+  using clock = std::chrono::high_resolution_clock;
+  auto start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    for (int j = 0; j < 1024; j++) out[j] = frames.eval({in[j]})[0];
+  }
+  const auto frame_time = (clock::now() - start) / iterations;
+  start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    process(buffers, BufferView<1>({in.data()}, 1024), BufferView<1>({out.data()}, 1024));
+  }
+  const auto buffer_time = (clock::now() - start) / iterations;
+  std::cout << "One pole filter, " << iterations << " iterations, average per frame: " << frame_time.count()
+            << "ns, per buffer: " << buffer_time.count() << "ns\n";
+
+  // With the coefficient as a second input, solved frame by frame before
+  ABlock<2, 1> auto const modulated = ((_, _ << (_, _), _) | ((_ * _, (1 - _) * _) | plus)) % _;
+  std::array<float, 1024> coef = {};
+  for (std::size_t j = 0; j < coef.size(); j++) coef[j] = 0.5f + 0.4f * in[(j * 7) % in.size()];
+  auto modulated_frames = make_evaluator(modulated);
+  auto modulated_buffers = make_evaluator(modulated);
+  start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    for (int j = 0; j < 1024; j++) out[j] = modulated_frames.eval({in[j], coef[j]})[0];
+  }
+  const auto modulated_frame_time = (clock::now() - start) / iterations;
+  start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    process(modulated_buffers, BufferView<2>({in.data(), coef.data()}, 1024), BufferView<1>({out.data()}, 1024));
+  }
+  const auto modulated_buffer_time = (clock::now() - start) / iterations;
+  std::cout << "Modulated one pole filter, " << iterations << " iterations, average per frame: "
+            << modulated_frame_time.count() << "ns, per buffer: " << modulated_buffer_time.count() << "ns\n";
+}
+
+/// Average time to process a buffer of 1024 samples with the block `b`
+template<eda::AnyBlock Block>
+auto buffer_time(const Block& b)
+{
+  using namespace eda;
+  std::array<float, 1024> in = {};
+  fill_random(in);
+  std::array<float, 1024> out = {};
+  // FIR filters with long kernels are too large for the stack
+  auto e = std::make_unique<evaluator<Block>>(b);
+
+  int iterations = 200;
+  float checksum = 0;
+  using clock = std::chrono::high_resolution_clock;
+  const auto start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    process(*e, BufferView<1>({in.data()}, 1024), BufferView<1>({out.data()}, 1024));
+    // Keeps the output from being optimized away
+    checksum += out[i];
+  }
+  REQUIRE(std::isfinite(checksum));
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start) / iterations;
+}
+
+TEST_CASE ("Convolution benchmark") {
+  using namespace eda;
+  const auto compare = [&]<std::size_t N>(std::integral_constant<std::size_t, N>) {
+    std::array<float, N> kernel = {};
+    fill_random(kernel);
+    std::cout << "Convolution, " << N << " taps, per buffer of 1024, FIR: " << buffer_time(fir(kernel)).count()
+              << "ns, FFT: " << buffer_time(convolve(kernel)).count() << "ns\n";
+  };
+  // Finely spaced around the crossover, where the FFT path starts being faster
+  compare(std::integral_constant<std::size_t, 16>());
+  compare(std::integral_constant<std::size_t, 32>());
+  compare(std::integral_constant<std::size_t, 48>());
+  compare(std::integral_constant<std::size_t, 64>());
+  compare(std::integral_constant<std::size_t, 96>());
+  compare(std::integral_constant<std::size_t, 128>());
+  compare(std::integral_constant<std::size_t, 192>());
+  compare(std::integral_constant<std::size_t, 256>());
+  compare(std::integral_constant<std::size_t, 1024>());
+  compare(std::integral_constant<std::size_t, 4096>());
+}
+
+TEST_CASE ("Mix benchmark") {
+  using namespace eda;
+  constexpr std::size_t channels = 32;
+  constexpr std::size_t size = 1024;
+  std::array<float, channels * channels> gains;
+  fill_random(gains);
+  auto frames = make_evaluator(mix<channels, channels>(gains));
+  auto buffers = make_evaluator(mix<channels, channels>(gains));
+  AudioBuffer<channels> in(size);
+  for (std::size_t c = 0; c < channels; c++) {
+    std::span<float> data(in[c], size);
+    fill_random(data);
+  }
+  AudioBuffer<channels> out(size);
+
+  int iterations = 100;
+  float checksum = 0;
+  using clock = std::chrono::high_resolution_clock;
+  auto start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    for (std::size_t j = 0; j < size; j++) {
+      const auto res = frames.eval(in.view().frame(j));
+      for (std::size_t c = 0; c < channels; c++) out[c][j] = res[c];
+    }
+    checksum += out[i % channels][i];
+  }
+  const auto frame_time = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start) / iterations;
+  start = clock::now();
+  for (int i = 0; i < iterations; i++) {
+    process(buffers, in.view(), out.view());
+    checksum += out[i % channels][i];
+  }
+  const auto buffer_time = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start) / iterations;
+  REQUIRE(std::isfinite(checksum));
+  std::cout << "Mix, " << channels << "x" << channels << ", per buffer of " << size << ", frames: " << frame_time.count()
+            << "ns, buffers: " << buffer_time.count() << "ns\n";
+}
+
+TEST_CASE ("Kernel dispatch benchmark") {
+  using namespace eda;
+  constexpr std::size_t channels = 32;
+  std::array<float, channels * channels> gains;
+  fill_random(gains);
+  std::vector<float> h(4096);
+  fill_random(h);
+  AudioBuffer<channels> in(1024);
+  for (std::size_t c = 0; c < channels; c++) {
+    std::span<float> data(in[c], 1024);
+    fill_random(data);
+  }
+  AudioBuffer<channels> out(1024);
+
+  for (auto isa : {util::Isa::generic, util::Isa::sse42, util::Isa::avx2, util::Isa::avx512}) {
+    // Evaluators select their kernels when made
+    if (util::force_isa(isa) != isa) break;
+    auto m = make_evaluator(mix<channels, channels>(gains));
+    using clock = std::chrono::high_resolution_clock;
+    const auto start = clock::now();
+    float checksum = 0;
+    for (int i = 0; i < 100; i++) {
+      process(m, in.view(), out.view());
+      checksum += out[i % channels][i];
+    }
+    const auto mix_time = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start) / 100;
+    REQUIRE(std::isfinite(checksum));
+    std::cout << "Kernels for " << util::isa_name(isa) << ", per buffer of 1024, mix " << channels << "x" << channels
+              << ": " << mix_time.count() << "ns, convolution 4096 taps: " << buffer_time(convolve(h)).count() << "ns\n";
+  }
+  util::force_isa(util::Isa::avx512);
+}
@@ -1,6 +1,8 @@
+#include "eda/arena.hpp"
 #include "eda/block.hpp"
 #include "eda/syntax.hpp"
 #include "eda/evaluator.hpp"
+#include "eda/resampling.hpp"
 
 #include <catch2/catch_all.hpp>
 
@@ -70,6 +72,43 @@ namespace eda {
     REQUIRE(e.eval({3}) == Frame(2, 3));
   }
 
+  TEST_CASE ("Linear recurrence") {
+    float a = 0.9f;
+    auto one_pole = (_ * _, (1 - _) * _) | plus;
+    auto filter = (_ << (_, _), _) | (one_pole % _);
+    static_assert(is_linear_recurrence_v<decltype(one_pole(_, ref(a), ref(a))), Ident<1>>);
+    static_assert(is_linear_recurrence_v<decltype(_ + eda::tanh), decltype(_ * 0.5f)>);
+    // The coefficient of the fed back signal depends on the input
+    static_assert(!is_linear_recurrence_v<decltype(one_pole), Ident<1>>);
+    static_assert(!is_linear_recurrence_v<decltype(eda::tanh + _), Ident<1>>);
+    static_assert(!is_linear_recurrence_v<decltype((_ << times, _) | plus), Ident<1>>);
+    static_assert(!is_linear_recurrence_v<Plus, Mem<1>>);
+    // Still affine in the fed back signal, with a coefficient that varies
+    static_assert(is_affine_recurrence_v<decltype(one_pole), Ident<1>>);
+    static_assert(!is_affine_recurrence_v<decltype((_ << times, _) | plus), Ident<1>>);
+    static_assert(!is_affine_recurrence_v<decltype(eda::tanh + _), Ident<1>>);
+    static_assert(!is_affine_recurrence_v<Plus, Mem<1>>);
+
+    auto compare = [](auto block, auto input) {
+      auto frames = make_evaluator(block);
+      auto buffer = make_evaluator(block);
+      std::array<float, 200> out = {};
+      process(buffer, BufferView<1>({input.data()}, 200), BufferView<1>({out.data()}, 200));
+      for (std::size_t i = 0; i < 200; i++) REQUIRE(std::abs(frames.eval({input[i]})[0] - out[i]) < 1e-5f);
+    };
+    std::array<float, 200> input;
+    for (std::size_t i = 0; i < 200; i++) input[i] = std::sin(i * 0.3f) + (i % 7 == 0 ? 1.f : 0.f);
+
+    compare(one_pole(_, ref(a), ref(a)) % _, input);
+    compare(filter(ref(a)), input);
+    compare((_ + eda::tanh) % (_ * 0.5f), input);
+    compare((_ + _) % (_ * ref(a) * 0.99f), input);
+    // With a coefficient computed from the input
+    compare(((_, _ << (eda::tanh * 0.5f, _)) | (_, _ << (_, _), _) | one_pole) % _, input);
+    // Not affine, evaluated frame by frame
+    compare((plus | eda::tanh) % _, input);
+  }
+
   TEST_CASE ("Currying") {
     REQUIRE(eval((_, _, _, _)(1, 2, 3), {4}) == Frame(1, 2, 3, 4));
     auto f1 = (_ + 1);
@@ -129,10 +168,12 @@ namespace eda {
     REQUIRE(e.eval({3, 15}) == Frame(12));
     REQUIRE(e.eval({4, 16}) == Frame(12));
     REQUIRE(e.eval({5, 17}) == Frame(12));
-    REQUIRE(e.eval({6, 18}) == Frame(0));
+    // Longer delays read further back into the history, which is allocated up front
+    REQUIRE(e.history().size() == default_delay_capacity);
+    REQUIRE(e.eval({6, 18}) == Frame(12));
     REQUIRE(e.eval({6, 19}) == Frame(13));
-    REQUIRE(e.eval({8, 20}) == Frame(0));
-    REQUIRE(e.eval({8, 21}) == Frame(0));
+    REQUIRE(e.eval({8, 20}) == Frame(12));
+    REQUIRE(e.eval({8, 21}) == Frame(13));
     REQUIRE(e.eval({8, 22}) == Frame(14));
     REQUIRE(e.eval({8, 23}) == Frame(15));
     REQUIRE(e.eval({8, 24}) == Frame(16));
@@ -142,6 +183,143 @@ namespace eda {
     REQUIRE(e.eval({8, 28}) == Frame(20));
     REQUIRE(e.eval({8, 29}) == Frame(21));
     REQUIRE(e.eval({8, 30}) == Frame(22));
+
+    // Delays longer than the capacity are clamped to it
+    auto clamped = make_evaluator(delay);
+    const float d = default_delay_capacity + 1000;
+    std::size_t echoes = 0;
+    std::size_t echo = 0;
+    for (std::size_t i = 0; i < d + 1; i++) {
+      if (clamped.eval({d, i == 0 ? 1.f : 0.f}) != Frame(0)) echoes++, echo = i;
+    }
+    REQUIRE(echoes == 1);
+    REQUIRE(echo == default_delay_capacity);
+  }
+
+  TEST_CASE ("Sample storage") {
+    REQUIRE(storage::f16::decode(storage::f16::encode(0.5f)) == 0.5f);
+    REQUIRE(storage::f16::decode(storage::f16::encode(-1024.f)) == -1024.f);
+    REQUIRE(storage::f16::decode(storage::f16::encode(0x1p-24f)) == 0x1p-24f);
+    REQUIRE(std::isinf(storage::f16::decode(storage::f16::encode(1e6f))));
+    REQUIRE(std::abs(storage::f16::decode(storage::f16::encode(0.3f)) - 0.3f) <= 0.3f * 0x1p-11f);
+    REQUIRE(storage::i16::decode(storage::i16::encode(2.f)) == 1.f);
+    REQUIRE(std::abs(storage::i16::decode(storage::i16::encode(-0.3f)) + 0.3f) <= 0.5f / 32767);
+    REQUIRE(std::abs(storage::i24::decode(storage::i24::encode(-0.3f)) + 0.3f) <= 0.5f / 8388607);
+
+    std::array<float, 100> in;
+    for (std::size_t i = 0; i < in.size(); i++) in[i] = std::sin(i * 0.1f);
+
+    auto check_buffer_path = [&](auto block) {
+      auto e1 = make_evaluator(block);
+      auto e2 = make_evaluator(block);
+      std::array<float, 100> out1 = {};
+      std::array<float, 100> out2 = {};
+      for (std::size_t i = 0; i < in.size(); i++) out1[i] = e1.eval({in[i]});
+      process(e2, BufferView<1>({in.data()}, in.size()), BufferView<1>({out2.data()}, out2.size()));
+      REQUIRE(out1 == out2);
+      for (std::size_t i = 7; i < in.size(); i++) REQUIRE(std::abs(out1[i] - in[i - 7]) < 1e-3f);
+    };
+    check_buffer_path(mem<7, storage::f16>);
+    check_buffer_path(mem<7, storage::i16>);
+    check_buffer_path(mem<7, storage::i24>);
+    check_buffer_path(delay_as<storage::f16>(7));
+    check_buffer_path(delay_as<storage::i24>(7));
+  }
+
+  TEST_CASE ("fixed_delay") {
+    auto e = make_evaluator(fixed_delay(4));
+    REQUIRE(e.history().size() == 4);
+    REQUIRE(e.eval({2, 1}) == Frame(0));
+    REQUIRE(e.eval({2, 2}) == Frame(0));
+    REQUIRE(e.eval({2, 3}) == Frame(1));
+    // Longer delays are clamped to the capacity
+    REQUIRE(e.eval({10, 4}) == Frame(0));
+    REQUIRE(e.eval({10, 5}) == Frame(1));
+    REQUIRE(e.history().size() == 4);
+  }
+
+  TEST_CASE ("multitap") {
+    SECTION ("Matches separate delays") {
+      auto taps = make_evaluator(multitap<3>);
+      auto d0 = make_evaluator(delay);
+      auto d1 = make_evaluator(delay);
+      auto d2 = make_evaluator(delay);
+      for (int i = 1; i < 50; i++) {
+        const float x = float(i);
+        REQUIRE(taps.eval({2, 5, 9, x}) == Frame<3>{d0.eval({2, x})[0], d1.eval({5, x})[0], d2.eval({9, x})[0]});
+      }
+    }
+
+    SECTION ("Delay times change while running") {
+      auto e = make_evaluator(fixed_multitap<2>(64));
+      for (int i = 1; i < 100; i++) {
+        const int t0 = i / 10 + 1;
+        const int t1 = 40 - i % 30;
+        const auto res = e.eval({float(t0), float(t1), float(i)});
+        REQUIRE(res == Frame<2>{float(std::max(i - t0, 0)), float(std::max(i - t1, 0))});
+      }
+    }
+
+    SECTION ("Processing buffers matches evaluating frames") {
+      auto frames = make_evaluator(fixed_multitap<2>(50));
+      auto buffers = make_evaluator(fixed_multitap<2>(50));
+      REQUIRE(buffers.history().size() == 50);
+      constexpr std::size_t n = 200;
+      AudioBuffer<3> in(n);
+      for (std::size_t i = 0; i < n; i++) {
+        in[0][i] = float(i % 7);
+        in[1][i] = float(60 - i % 40);
+        in[2][i] = float(i);
+      }
+      AudioBuffer<2> out(n);
+      process(buffers, in.view(), out.view());
+      for (std::size_t i = 0; i < n; i++) {
+        REQUIRE(frames.eval(in.view().frame(i)) == Frame<2>{out[0][i], out[1][i]});
+      }
+      REQUIRE(buffers.history().size() == 50);
+    }
+  }
+
+  TEST_CASE ("reset") {
+    auto e = make_evaluator((_ << (_, mem<1>) >> _, mem<100>) | (_, delay(3)));
+    auto run = [&] {
+      std::vector<Frame<2>> res;
+      for (int i = 1; i < 200; i++) res.push_back(e.eval({float(i), float(i)}));
+      return res;
+    };
+    auto first = run();
+    reset(e);
+    REQUIRE(run() == first);
+  }
+
+  TEST_CASE ("ArenaEvaluator") {
+    float delay_time = 10;
+    auto block = (mem<100> | fixed_delay(1000)(ref(delay_time)), mem<3>) >> _;
+    auto plain = make_evaluator(block);
+    auto arena = make_arena_evaluator(block);
+    REQUIRE(arena.history_bytes() == 448 + 4032);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&*arena) % 64 == 0);
+
+    for_each_history(*arena, [&](auto& h) {
+      auto* p = reinterpret_cast<std::byte*>(h.data());
+      REQUIRE(p >= reinterpret_cast<std::byte*>(&*arena));
+      REQUIRE(p < reinterpret_cast<std::byte*>(&*arena) + arena.bytes());
+      REQUIRE(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+    });
+
+    std::vector<Frame<1>> expected;
+    for (int i = 0; i < 300; i++) {
+      expected.push_back(plain.eval({float(i), float(i)}));
+      REQUIRE(arena.eval({float(i), float(i)}) == expected.back());
+    }
+
+    // Copies get their own arena
+    auto copy = arena;
+    arena.reset();
+    for (int i = 0; i < 300; i++) {
+      REQUIRE(arena.eval({float(i), float(i)}) == expected[i]);
+    }
+    REQUIRE(copy.eval({300, 300}) == plain.eval({300, 300}));
   }
 
   TEST_CASE("FunBlock") {
@@ -151,8 +329,145 @@ namespace eda {
     REQUIRE(eval(f, {10}) == Frame(10, 20));
   }
 
+  TEST_CASE ("Control rate") {
+    static_assert(AControlRateBlock<decltype(1 - ref(std::declval<float&>()))>);
+    static_assert(AControlRateBlock<decltype((1_eda, 2_eda) | plus)>);
+    static_assert(!AControlRateBlock<decltype(_ + 1)>);
+    static_assert(!AControlRateBlock<decltype(delay(1_eda, 2_eda))>);
+
+    float param = 1;
+    int evaluations = 0;
+    struct Counted {
+      Frame<1> operator()(Frame<1> in) const
+      {
+        (*evaluations)++;
+        return in;
+      }
+      int* evaluations;
+    };
+    auto counted = fun<1, 1>(Counted{&evaluations});
+    auto e = make_evaluator(_ * (counted(ref(param)) * 2));
+    std::array<float, 8> in = {1, 1, 1, 1, 1, 1, 1, 1};
+    std::array<float, 8> out = {};
+    process(e, BufferView<1>({in.data()}, 8), BufferView<1>({out.data()}, 8));
+    REQUIRE(evaluations == 1);
+    REQUIRE(out == std::array<float, 8>{2, 2, 2, 2, 2, 2, 2, 2});
+
+    // Evaluating frame by frame sees parameter changes immediately
+    param = 3;
+    REQUIRE(e.eval({1}) == Frame(6));
+    REQUIRE(evaluations == 2);
+
+    SECTION ("Smoothing") {
+      auto s = make_evaluator(_ * smooth(ref(param)));
+      std::array<float, 4> out4 = {};
+      process(s, BufferView<1>({in.data()}, 4), BufferView<1>({out4.data()}, 4));
+      REQUIRE(out4 == std::array<float, 4>{3, 3, 3, 3});
+      param = 7;
+      process(s, BufferView<1>({in.data()}, 4), BufferView<1>({out4.data()}, 4));
+      REQUIRE(out4 == std::array<float, 4>{4, 5, 6, 7});
+    }
+
+    SECTION ("Smoothing within a larger parameter expression") {
+      static_assert(contains_smooth_v<decltype(smooth(ref(param)) * 2)>);
+      static_assert(!contains_smooth_v<decltype(ref(param) * 2)>);
+      auto s = make_evaluator(_ * (smooth(ref(param)) * 2));
+      std::array<float, 4> out4 = {};
+      process(s, BufferView<1>({in.data()}, 4), BufferView<1>({out4.data()}, 4));
+      REQUIRE(out4 == std::array<float, 4>{6, 6, 6, 6});
+      param = 7;
+      process(s, BufferView<1>({in.data()}, 4), BufferView<1>({out4.data()}, 4));
+      REQUIRE(out4 == std::array<float, 4>{8, 10, 12, 14});
+    }
+
+    SECTION ("Smoothing at a higher rate") {
+      // Ramps over the frames of the buffer, not over the evaluations of the inner block
+      auto s = make_evaluator(resample<2>(_ * smooth(ref(param)), mem<0>, mem<0>));
+      std::array<float, 8> out8 = {};
+      process(s, BufferView<1>({in.data()}, 8), BufferView<1>({out8.data()}, 8));
+      param = 11;
+      process(s, BufferView<1>({in.data()}, 8), BufferView<1>({out8.data()}, 8));
+      // Zero stuffing scales the input by 2, and the frame is evaluated first of its 2
+      for (std::size_t i = 0; i < 8; i++) REQUIRE(out8[i] == Approx(2 * (3 + 0.5f * (2 * i + 1))));
+    }
+  }
+
+  TEST_CASE ("Latency") {
+    STATIC_REQUIRE(latency<decltype(_ + 1)> == 0);
+    STATIC_REQUIRE(latency<decltype(mem<3> | fir<5>({}))> == 2);
+    STATIC_REQUIRE(latency<decltype((mem<3>, mem<1>))> == 0);
+    STATIC_REQUIRE(latency<decltype((_ + _) % mem<10>)> == 0);
+    STATIC_REQUIRE(latency<decltype(resample<2>(_))> == 64);
+    // Rounded up, and made exact by delaying the inner block by the rest
+    STATIC_REQUIRE(latency<decltype(resample<2>(fir<3>({0, 1, 0})))> == 65);
+    STATIC_REQUIRE(latency<decltype(compensate_latency(resample<2>(fir<3>({0, 1, 0}))))> == 65);
+    STATIC_REQUIRE(latency<decltype(std::get<0>(compensate_latency(resample<2>(fir<3>({0, 1, 0}))).operands))> == 130);
+    {
+      auto e = make_evaluator(compensate_latency(resample<2>(fir<3>({0, 1, 0}))));
+      std::size_t peak = 0;
+      float max = 0;
+      for (std::size_t i = 0; i < 100; i++) {
+        const float y = std::abs(e.eval({i == 0 ? 1.f : 0.f})[0]);
+        if (y > max) max = y, peak = i;
+      }
+      REQUIRE(peak == 65);
+    }
+
+    // A dry/wet mix, where the wet branch is late
+    auto block = _ << (fir<7>({0, 0, 0, 1, 0, 0, 0}) * 0.5) + (_ * 0.5);
+    STATIC_REQUIRE(latency<decltype(block)> == 3);
+    auto compensated = compensate_latency(block);
+    STATIC_REQUIRE(latency<decltype(compensated)> == 3);
+    STATIC_REQUIRE(std::same_as<decltype(compensate_latency(compensated)), decltype(compensated)>);
+
+    auto e = make_evaluator(compensated);
+    REQUIRE(e.eval({1}) == Frame(0));
+    REQUIRE(e.eval({0}) == Frame(0));
+    REQUIRE(e.eval({0}) == Frame(0));
+    REQUIRE(e.eval({0}) == Frame(1));
+    REQUIRE(e.eval({0}) == Frame(0));
+
+    // Inputs of partial applications that are not given are aligned too
+    auto partial = compensate_latency(plus(fir<5>({0, 0, 1, 0, 0})));
+    STATIC_REQUIRE(ins<decltype(partial)> == 2);
+    auto p = make_evaluator(partial);
+    REQUIRE(p.eval({1, 1}) == Frame(0));
+    REQUIRE(p.eval({0, 0}) == Frame(0));
+    REQUIRE(p.eval({0, 0}) == Frame(2));
+
+    // Intentional delays are part of the signal, and are left alone
+    auto comb = _ << ((_, mem<3>) >> plus);
+    STATIC_REQUIRE(latency<decltype(comb)> == 0);
+    STATIC_REQUIRE(std::same_as<decltype(compensate_latency(comb)), decltype(comb)>);
+    auto c = make_evaluator(compensate_latency(comb));
+    REQUIRE(c.eval({1}) == Frame(1));
+    REQUIRE(c.eval({0}) == Frame(0));
+    REQUIRE(c.eval({0}) == Frame(0));
+    REQUIRE(c.eval({0}) == Frame(1));
+    REQUIRE(c.eval({0}) == Frame(0));
+  }
+
   TEST_CASE("Resample") {
-    // const auto f = resample<2>(mem<1>);
+    // const auto f = resample<2>(fir<3>({0, 1, 0}));
+
+    SECTION ("Oversampling cascade") {
+      using Stage = decltype(resample<2>(_, halfband, halfband));
+      STATIC_REQUIRE(std::same_as<decltype(oversample<2>(_)), Stage>);
+      STATIC_REQUIRE(std::same_as<decltype(resample<8>(_)), decltype(oversample<8>(_))>);
+
+      auto check_passthrough = [](auto e) {
+        float peak = 0;
+        for (int i = 0; i < 1000; i++) {
+          const float out = e.eval({std::sin(i * 0.1f)})[0];
+          if (i > 500) peak = std::max(peak, std::abs(out));
+        }
+        REQUIRE(std::abs(peak - 1) < 1e-2f);
+      };
+      check_passthrough(make_evaluator(oversample<4>(_)));
+      check_passthrough(make_evaluator(oversample<8>(_)));
+      check_passthrough(make_evaluator(resample<16>(_)));
+      check_passthrough(make_evaluator(oversample_cascade(_, halfband_firwin, halfband_shortest)));
+    }
   }
 
 } // namespace eda
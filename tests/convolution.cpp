@@ -0,0 +1,111 @@
+#include "eda/convolution.hpp"
+#include "eda/syntax.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  namespace {
+    std::vector<float> random_signal(std::size_t n, unsigned seed)
+    {
+      std::mt19937 gen(seed);
+      std::uniform_real_distribution<float> dist(-1, 1);
+      std::vector<float> res(n);
+      for (auto& x : res) x = dist(gen);
+      return res;
+    }
+
+    /// Direct convolution of `x` with `h`, delayed by `delay` samples
+    std::vector<float> direct_convolution(const std::vector<float>& x, const std::vector<float>& h, std::size_t delay)
+    {
+      std::vector<float> res(x.size());
+      for (std::size_t n = delay; n < x.size(); n++) {
+        double acc = 0;
+        for (std::size_t i = 0; i < h.size() && i <= n - delay; i++) acc += h[i] * x[n - delay - i];
+        res[n] = static_cast<float>(acc);
+      }
+      return res;
+    }
+  } // namespace
+
+  TEST_CASE ("FFT") {
+    constexpr std::size_t n = 64;
+    const auto x = random_signal(n, 1);
+    util::RealFFT fft(n);
+    REQUIRE(fft.bins() == n / 2 + 1);
+    std::vector<float> re(fft.bins());
+    std::vector<float> im(fft.bins());
+    fft.forward(x.data(), re.data(), im.data());
+
+    SECTION ("Matches the DFT") {
+      for (std::size_t k = 0; k < fft.bins(); k++) {
+        double dft_re = 0;
+        double dft_im = 0;
+        for (std::size_t i = 0; i < n; i++) {
+          dft_re += x[i] * std::cos(2 * std::numbers::pi * k * i / n);
+          dft_im -= x[i] * std::sin(2 * std::numbers::pi * k * i / n);
+        }
+        REQUIRE(std::abs(re[k] - dft_re) < 1e-4);
+        REQUIRE(std::abs(im[k] - dft_im) < 1e-4);
+      }
+    }
+
+    SECTION ("Round trip") {
+      std::vector<float> y(n);
+      fft.inverse(re.data(), im.data(), y.data());
+      for (std::size_t i = 0; i < n; i++) REQUIRE(std::abs(y[i] / n - x[i]) < 1e-5f);
+    }
+  }
+
+  TEST_CASE ("Convolution") {
+    constexpr std::size_t block = 16;
+    const auto x = random_signal(1000, 2);
+    STATIC_REQUIRE(latency<Convolution<block>> == block);
+
+    SECTION ("Matches direct convolution") {
+      for (std::size_t length : {1, 15, 16, 17, 100}) {
+        const auto h = random_signal(length, 3);
+        const auto expected = direct_convolution(x, h, block);
+        auto e = make_evaluator(convolve<block>(h));
+        for (std::size_t i = 0; i < x.size(); i++) REQUIRE(std::abs(e.eval({x[i]})[0] - expected[i]) < 1e-4f);
+      }
+    }
+
+    SECTION ("Processing buffers matches evaluating frames") {
+      const auto h = random_signal(100, 4);
+      auto frames = make_evaluator(convolve<block>(h));
+      auto buffers = make_evaluator(convolve<block>(h));
+      std::vector<float> out = x;
+      // Buffers of odd sizes, processed in place, that do not line up with blocks
+      for (std::size_t i = 0, n = 1; i < out.size(); i += n, n = n * 3 % 37 + 1) {
+        n = std::min(n, out.size() - i);
+        process(buffers, BufferView<1>({out.data() + i}, n), BufferView<1>({out.data() + i}, n));
+      }
+      for (std::size_t i = 0; i < x.size(); i++) REQUIRE(frames.eval({x[i]})[0] == out[i]);
+    }
+
+    SECTION ("Quiescence") {
+      const auto h = random_signal(40, 5);
+      auto e = make_evaluator(convolve<block>(h));
+      REQUIRE(is_quiescent(e));
+      e.eval({1.f});
+      REQUIRE_FALSE(is_quiescent(e));
+      float peak = 0;
+      for (std::size_t i = 0; i < tail_length(e); i++) peak = std::max(peak, std::abs(e.eval({0.f})[0]));
+      REQUIRE(peak > 0);
+      REQUIRE(is_quiescent(e));
+      REQUIRE(std::abs(e.eval({0.f})[0]) <= silence_threshold);
+
+      e.reset();
+      REQUIRE(e.eval({0.f})[0] == 0);
+    }
+  }
+
+} // namespace eda
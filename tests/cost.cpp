@@ -0,0 +1,85 @@
+#include "eda/cost.hpp"
+#include "eda/resampling.hpp"
+#include "eda/syntax.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("Cost") {
+    SECTION ("Leaves") {
+      STATIC_REQUIRE(cost<Ident<2>>.ops() == 0);
+      STATIC_REQUIRE(cost<Plus>.adds == 1);
+      STATIC_REQUIRE(cost<Times>.muls == 1);
+      STATIC_REQUIRE(cost<decltype(eda::tanh)>.calls == 1);
+      STATIC_REQUIRE(cost<FIRFilter<33>>.macs == 33);
+      STATIC_REQUIRE(cost<Mix<4, 3>>.macs == 12);
+      STATIC_REQUIRE(cost<SamplePlayer<storage::i16>>.scratch_bytes > process_chunk * sizeof(double));
+      STATIC_REQUIRE(cost<Plus>.state_bytes == sizeof(evaluator<Plus>));
+      STATIC_REQUIRE(cost<Cut<3>>.ops() == 0);
+      STATIC_REQUIRE(cost<Erased<1, 1>>.calls == 1);
+    }
+
+    SECTION ("Compositions") {
+      constexpr auto gain = _ * 0.5f | eda::tanh;
+      STATIC_REQUIRE(cost<decltype(gain)>.muls == 1);
+      STATIC_REQUIRE(cost<decltype(gain)>.calls == 1);
+      STATIC_REQUIRE(cost<decltype(gain)>.copies == 1);
+      STATIC_REQUIRE(cost<decltype(gain)>.scratch_bytes == sizeof(ScratchBuffer<1>));
+
+      // Merging three channels into one takes two additions
+      STATIC_REQUIRE(cost<decltype((_, _, _) >> _)>.adds == 2);
+      // The scratch of the merge stays alive while its operands use their own
+      STATIC_REQUIRE(cost<decltype((_, _) >> _)>.scratch_bytes > sizeof(ScratchBuffer<2>) + sizeof(ScratchBuffer<1>));
+
+      // Linear loops are solved a chunk at a time, others frame by frame
+      STATIC_REQUIRE(cost<decltype((plus | _ * 0.5f) % _)>.scratch_bytes >= 3 * sizeof(ScratchBuffer<1>));
+      STATIC_REQUIRE(cost<decltype((plus | eda::tanh) % _)>.scratch_bytes == sizeof(ScratchBuffer<1>));
+    }
+
+    SECTION ("Memory") {
+      STATIC_REQUIRE(cost<Mem<4>>.history_bytes == 0);
+      STATIC_REQUIRE(cost<Mem<1000>>.history_bytes == 4000);
+      STATIC_REQUIRE(cost<Mem<1000, storage::f16>>.history_bytes == 2000);
+      STATIC_REQUIRE(cost<decltype((mem<1000>, mem<1000>))>.history_bytes == 8000);
+      // The whole capacity of a delay is allocated up front
+      STATIC_REQUIRE(cost<Delay>.history_bytes == default_delay_capacity * sizeof(float));
+      STATIC_REQUIRE(cost<BasicDelay<storage::f16>>.history_bytes == default_delay_capacity * 2);
+      STATIC_REQUIRE(cost<MultiTap<3>>.history_bytes == default_delay_capacity * sizeof(float));
+    }
+
+    SECTION ("FFT convolution is cheaper than a direct FIR filter for long kernels only") {
+      STATIC_REQUIRE(cost<Convolution<64>>.ops() < cost<FIRFilter<64>>.ops());
+      STATIC_REQUIRE(cost<Convolution<16>>.ops() > cost<FIRFilter<16>>.ops());
+      STATIC_REQUIRE(cost<Convolution<64>>.history_bytes > 0);
+    }
+
+    SECTION ("STFT operations are spread over each hop") {
+      constexpr auto spectral = [](std::span<float>, std::span<float>) {};
+      using Hop4 = decltype(stft<256, 64>(spectral));
+      using Hop2 = decltype(stft<256, 128>(spectral));
+      STATIC_REQUIRE(cost<Hop4>.calls == 1. / 64);
+      STATIC_REQUIRE(cost<Hop4>.ops() > cost<Hop2>.ops());
+      STATIC_REQUIRE(cost<Hop4>.history_bytes >= 3 * 256 * sizeof(float));
+    }
+
+    SECTION ("Resampling multiplies the cost of the inner block") {
+      using Inner = decltype(halfband_short | eda::tanh | halfband_short);
+      STATIC_REQUIRE(cost<decltype(resample<2>(eda::tanh, halfband_short, halfband_short))>.macs == 2 * 2 * 23);
+      STATIC_REQUIRE(cost<decltype(resample<2>(eda::tanh, halfband_short, halfband_short))>.calls == 2);
+      STATIC_REQUIRE(cost<decltype(oversample<8>(eda::tanh))>.calls == 8);
+      STATIC_REQUIRE(cost<decltype(oversample<8>(eda::tanh))>.macs == 2 * (2 * 129 + 2 * (2 * 23 + 2 * (2 * 15))));
+      STATIC_REQUIRE(cost<Inner>.macs == 2 * 23);
+    }
+
+    SECTION ("Budgets") {
+      constexpr auto echo = (_ + _) % (_ * 0.5f | mem<3>);
+      static_assert(cost<decltype(echo)>.ops() <= 8);
+      static_assert(cost<decltype(echo)>.footprint() <= 4096);
+      REQUIRE(cost<decltype(echo)>.ops() == 6);
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,95 @@
+#include "eda/convolution.hpp"
+#include "eda/internal/cpu.hpp"
+#include "eda/mix.hpp"
+#include "eda/storage.hpp"
+#include "eda/syntax.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+  using util::Isa;
+
+  TEST_CASE ("CPU dispatch") {
+    constexpr std::array<Isa, 4> levels = {Isa::generic, Isa::sse42, Isa::avx2, Isa::avx512};
+
+    SECTION ("Levels") {
+      for (auto isa : levels) REQUIRE(util::parse_isa(util::isa_name(isa)) == isa);
+      REQUIRE_FALSE(util::parse_isa("avx3"));
+      REQUIRE(util::force_isa(Isa::generic) == Isa::generic);
+      REQUIRE(util::isa() == Isa::generic);
+      // Never above what the CPU supports
+      REQUIRE(util::force_isa(Isa::avx512) == util::supported_isa());
+    }
+
+    SECTION ("Detection") {
+      using F = util::CpuFeatures;
+      STATIC_REQUIRE(util::isa_for({}) == Isa::generic);
+      STATIC_REQUIRE(util::isa_for({.sse42 = true, .popcnt = true}) == Isa::sse42);
+      STATIC_REQUIRE(util::isa_for(F{true, true, true, true, true}) == Isa::avx2);
+      STATIC_REQUIRE(util::isa_for(F{true, true, true, true, true, true, true, true, true}) == Isa::avx512);
+      // The avx2 kernels convert half floats with F16C
+      STATIC_REQUIRE(util::isa_for(F{true, true, true, true, false, true, true, true, true}) == Isa::sse42);
+      // Each level needs the ones below it
+      STATIC_REQUIRE(util::isa_for(F{true, false, true, true, true, true, true, true, true}) == Isa::generic);
+    }
+
+    SECTION ("Selects the closest lower version") {
+      using fn = int (*)();
+      const util::Multiversioned<fn> kernels = {.generic = [] { return 0; }, .avx2 = [] { return 2; }};
+      REQUIRE(kernels.select(Isa::generic)() == 0);
+      REQUIRE(kernels.select(Isa::sse42)() == 0);
+      REQUIRE(kernels.select(Isa::avx2)() == 2);
+      REQUIRE(kernels.select(Isa::avx512)() == 2);
+    }
+
+    SECTION ("Kernels match the generic version") {
+      std::vector<float> x(1000);
+      for (std::size_t i = 0; i < x.size(); i++) x[i] = std::sin(i * 0.37f) * 0.9f;
+      std::array<float, 15> gains;
+      for (std::size_t i = 0; i < gains.size(); i++) gains[i] = 1.f / (i + 1);
+      std::vector<float> h(300);
+      for (std::size_t i = 0; i < h.size(); i++) h[i] = std::cos(i * 0.11f) / (i + 1);
+
+      /// Outputs of each kernel, for the current level
+      auto run = [&] {
+        std::vector<float> res;
+        auto m = make_evaluator(mix<3, 5>(gains));
+        AudioBuffer<5> out(x.size());
+        process(m, BufferView<3>({x.data(), x.data(), x.data()}, x.size()), out.view());
+        for (std::size_t c = 0; c < 5; c++) res.insert(res.end(), out[c], out[c] + x.size());
+        auto conv = make_evaluator(convolve(h));
+        std::vector<float> y(x.size());
+        process(conv, BufferView<1>({x.data()}, x.size()), BufferView<1>({y.data()}, y.size()));
+        res.insert(res.end(), y.begin(), y.end());
+        auto filter = make_evaluator(((_ * 0.9f, _ * 0.1f) | plus) % _);
+        process(filter, BufferView<1>({x.data()}, x.size()), BufferView<1>({y.data()}, y.size()));
+        res.insert(res.end(), y.begin(), y.end());
+        std::vector<std::uint16_t> half(x.size());
+        storage::encode<storage::f16>(x.data(), half.data(), x.size());
+        storage::decode<storage::f16>(half.data(), y.data(), y.size());
+        res.insert(res.end(), y.begin(), y.end());
+        // Delays select their storage kernels when they are made
+        auto delayed = make_evaluator(mem<100, storage::f16>);
+        process(delayed, BufferView<1>({x.data()}, x.size()), BufferView<1>({y.data()}, y.size()));
+        res.insert(res.end(), y.begin(), y.end());
+        return res;
+      };
+
+      util::force_isa(Isa::generic);
+      const auto expected = run();
+      for (auto isa : levels) {
+        if (util::force_isa(isa) != isa) break;
+        const auto res = run();
+        // Only differ by the rounding of fused multiply-adds
+        for (std::size_t i = 0; i < res.size(); i++) REQUIRE(std::abs(res[i] - expected[i]) < 1e-5f);
+      }
+      util::force_isa(Isa::avx512);
+    }
+  }
+
+} // namespace eda
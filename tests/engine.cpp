@@ -0,0 +1,215 @@
+#include "eda/engine.hpp"
+#include "eda/syntax.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("Buffer processing") {
+    std::array<float, 8> a = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<float, 8> b = {};
+    std::array<float, 8> c = {};
+
+    SECTION ("Sequential") {
+      auto e = make_evaluator((_ + 1) | (_ * 2));
+      process(e, BufferView<1>({a.data()}, 8), BufferView<1>({b.data()}, 8));
+      REQUIRE(b == std::array<float, 8>{4, 6, 8, 10, 12, 14, 16, 18});
+    }
+
+    SECTION ("Parallel in-place") {
+      // Swap channels, so each operand writes the input of the other
+      std::ranges::fill(b, 10);
+      auto e = make_evaluator((_ + 1, _ * 2));
+      process(e, BufferView<2>({a.data(), b.data()}, 8), BufferView<2>({b.data(), a.data()}, 8));
+      REQUIRE(b == std::array<float, 8>{2, 3, 4, 5, 6, 7, 8, 9});
+      REQUIRE(a == std::array<float, 8>{20, 20, 20, 20, 20, 20, 20, 20});
+    }
+
+    SECTION ("Split and Merge") {
+      auto block = (_, _ * 2) << repeat_par<16>(_ + 1) >> (_, _);
+      auto e1 = make_evaluator(block);
+      auto e2 = make_evaluator(block);
+      AudioBuffer<2> out(8);
+      process(e1, BufferView<2>({a.data(), b.data()}, 8), out);
+      for (std::size_t i = 0; i < 8; i++) {
+        REQUIRE(Frame(out[0][i], out[1][i]) == e2.eval({a[i], b[i]}));
+        REQUIRE(out[0][i] == 8 * (a[i] + 1));
+      }
+    }
+
+    SECTION ("Stateful blocks match per-frame evaluation") {
+      auto block = (_ << (_, mem<3>) >> _) | mem<1>;
+      auto e1 = make_evaluator(block);
+      auto e2 = make_evaluator(block);
+      process(e1, BufferView<1>({a.data()}, 8), BufferView<1>({b.data()}, 8));
+      for (std::size_t i = 0; i < 8; i++) c[i] = e2.eval({a[i]});
+      REQUIRE(b == c);
+    }
+
+    SECTION ("Parallel with a literal") {
+      auto e = make_evaluator((_, 1.f) | plus);
+      process(e, BufferView<1>({a.data()}, 8), BufferView<1>({b.data()}, 8));
+      REQUIRE(b == std::array<float, 8>{2, 3, 4, 5, 6, 7, 8, 9});
+    }
+
+    SECTION ("Graphs without inputs") {
+      float phase = 0;
+      auto ramp = fun<0, 1>([](Frame<0>, float& p) { return p += 0.25f; }, phase);
+      auto e = make_evaluator(ramp | (_ * 2));
+      process(e, BufferView<0>({}, 8), BufferView<1>({b.data()}, 8));
+      REQUIRE(b == std::array<float, 8>{0.5, 1, 1.5, 2, 2.5, 3, 3.5, 4});
+
+      auto constant = make_evaluator(1.f | eda::tanh);
+      process(constant, BufferView<0>({}, 8), BufferView<1>({c.data()}, 8));
+      REQUIRE(std::ranges::all_of(c, [](float x) { return x == std::tanh(1.f); }));
+      REQUIRE(process_or_skip(constant, BufferView<0>({}, 8), BufferView<1>({c.data()}, 8)));
+      REQUIRE(c[7] == std::tanh(1.f));
+    }
+  }
+
+  TEST_CASE ("Alignment") {
+    static_assert(alignof(Frame<1>) == alignof(float));
+    static_assert(alignof(Frame<4>) == 16);
+    static_assert(alignof(Frame<64>) == 64);
+    static_assert(detail::padded_channels<3> == 4);
+    static_assert(detail::padded_channels<8> == 8);
+    static_assert(detail::padded_channels<20> == 32);
+#ifdef EDA_PAD_FRAMES
+    static_assert(sizeof(Frame<3>) == 4 * sizeof(float));
+    static_assert(alignof(Frame<3>) == 16);
+    REQUIRE(Frame(1, 2, 3) == Frame(std::array<float, 3>{1, 2, 3}));
+    REQUIRE(std::ranges::distance(Frame<3>()) == 3);
+#else
+    static_assert(sizeof(Frame<3>) == 3 * sizeof(float));
+#endif
+
+    AudioBuffer<3> buf(100);
+    REQUIRE(buf.stride() == 112);
+    for (std::size_t c = 0; c < buf.channels(); c++) {
+      REQUIRE(reinterpret_cast<std::uintptr_t>(buf[c]) % 64 == 0);
+    }
+  }
+
+  TEST_CASE ("Engine") {
+    auto block = _ << (_ * 2, mem<1>) >> _;
+    Engine<decltype(block)> engine(block, 100, {.threads = 4, .buffer_size = 16, .pin_threads = false});
+    REQUIRE(engine.threads() == 4);
+
+    for (int tick = 0; tick < 3; tick++) {
+      for (std::size_t i = 0; i < engine.size(); i++) {
+        auto in = engine.input(i);
+        std::fill_n(in[0], in.size(), float(i));
+      }
+      engine.tick();
+      for (std::size_t i = 0; i < engine.size(); i++) {
+        auto out = engine.output(i);
+        // mem<1> outputs the previous frame, which is 0 at the very start only
+        REQUIRE(out[0][0] == (tick == 0 ? 2.f * i : 3.f * i));
+        REQUIRE(out[0][out.size() - 1] == 3.f * i);
+      }
+    }
+
+    engine.set_deadline(0, std::chrono::nanoseconds(0));
+    engine.tick(4);
+    REQUIRE(engine.stats(0).deadline_misses == 1);
+    REQUIRE(engine.stats(1).deadline_misses == 0);
+    REQUIRE(engine.stats(1).worst >= engine.stats(1).last);
+
+    SECTION ("Delay history is stored with each instance") {
+      auto delayed = fixed_delay(64)(8.f);
+      Engine<decltype(delayed)> e(delayed, 2, {.threads = 1, .buffer_size = 16, .pin_threads = false});
+      auto& inst = e.instance(1);
+      for_each_history(inst, [&](auto& h) {
+        const auto offset = reinterpret_cast<std::byte*>(h.data()) - reinterpret_cast<std::byte*>(&inst);
+        REQUIRE(offset >= static_cast<std::ptrdiff_t>(sizeof(inst)));
+        REQUIRE(offset < static_cast<std::ptrdiff_t>(sizeof(inst) + sizeof(CacheLine)));
+      });
+      std::fill_n(e.input(1)[0], 16, 1.f);
+      e.tick();
+      REQUIRE(e.output(1)[0][7] == 0);
+      REQUIRE(e.output(1)[0][8] == 1);
+    }
+  }
+
+  TEST_CASE ("Silence") {
+    // A decaying echo: 4 samples of delay fed back at half volume
+    auto echo = (_ + _) % (_ * 0.5 | mem<3>);
+    auto e = make_evaluator(echo);
+    REQUIRE(tail_length(e) == infinite_tail);
+    REQUIRE(tail_length(make_evaluator(mem<4> | fir<3>({1, 1, 1}))) == 7);
+    REQUIRE(tail_length(make_evaluator(_ + 1)) == 0);
+    REQUIRE(is_quiescent(e));
+
+    std::array<float, 16> in = {1};
+    std::array<float, 16> out = {};
+    auto view = [](auto& a) { return BufferView<1>({a.data()}, a.size()); };
+    REQUIRE_FALSE(process_or_skip(e, view(in), view(out)));
+    REQUIRE(out[4] == 0.5f);
+    REQUIRE_FALSE(is_quiescent(e));
+
+    // The echo keeps going after the input stops, until it decays below the threshold
+    in = {};
+    int processed = 0;
+    while (!process_or_skip(e, view(in), view(out))) processed++;
+    REQUIRE(processed > 0);
+    REQUIRE(is_quiescent(e));
+    REQUIRE(std::ranges::all_of(out, [](float x) { return std::abs(x) <= silence_threshold; }));
+
+    in[3] = 1;
+    REQUIRE_FALSE(process_or_skip(e, view(in), view(out)));
+    REQUIRE(std::abs(out[3] - 1) <= silence_threshold);
+
+    SECTION ("Loops that feed back a constant are never quiescent") {
+      auto ramp = (plus | (_ + 0.01f)) % _;
+      auto skipping = make_evaluator(ramp);
+      auto reference = make_evaluator(ramp);
+      REQUIRE_FALSE(is_quiescent(skipping));
+      std::array<float, 16> zeros = {};
+      std::array<float, 16> expected = {};
+      for (int buffer = 0; buffer < 2; buffer++) {
+        REQUIRE_FALSE(process_or_skip(skipping, view(zeros), view(out)));
+        process(reference, view(zeros), view(expected));
+        REQUIRE(out == expected);
+      }
+      REQUIRE(std::abs(out[15] - 0.32f) < 1e-5f);
+      REQUIRE_FALSE(is_quiescent(skipping));
+    }
+
+    SECTION ("Loops are known to rest from their types, without evaluating them") {
+      STATIC_REQUIRE(propagate_silence<decltype(_ * 0.5 | mem<3>)>({true})[0]);
+      STATIC_REQUIRE_FALSE(propagate_silence<decltype(_ + 0.01f)>({true})[0]);
+      STATIC_REQUIRE_FALSE(propagate_silence<std::remove_cvref_t<decltype(eda::sin)>>({true})[0]);
+      static int calls = 0;
+      auto counted = fun<1, 1>([](auto in) {
+        calls++;
+        return in[0];
+      });
+      auto loop = make_evaluator((plus | counted) % (_ * 0.5));
+      REQUIRE(calls == 0);
+      // Functions may not keep silence, so the loop only settles after a silent frame
+      REQUIRE_FALSE(is_quiescent(loop));
+      loop.eval({0});
+      REQUIRE(is_quiescent(loop));
+    }
+
+    SECTION ("Skipped buffers repeat the first output") {
+      auto constant = make_evaluator(_ + 1);
+      std::array<float, 16> zeros = {};
+      REQUIRE(process_or_skip(constant, view(zeros), view(out)));
+      REQUIRE(std::ranges::all_of(out, [](float x) { return x == 1; }));
+    }
+
+    SECTION ("Engine") {
+      auto block = _ * 2 | delay(8);
+      Engine<decltype(block)> engine(block, 2, {.threads = 1, .buffer_size = 16, .skip_silence = true});
+      std::fill_n(engine.input(0)[0], 16, 1.f);
+      engine.tick();
+      engine.tick();
+      REQUIRE(engine.stats(0).skipped == 0);
+      REQUIRE(engine.stats(1).skipped == 2);
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,57 @@
+#include "eda/erased.hpp"
+#include "eda/syntax.hpp"
+
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  namespace {
+    float time_samples = 10;
+    float feedback = 0.5;
+
+    /// Would be defined in its own translation unit, and declared in a header
+    Erased<1, 1> make_echo()
+    {
+      return erased((plus | delay(ref(time_samples))) % (_ * ref(feedback)));
+    }
+  } // namespace
+
+  TEST_CASE ("Erased") {
+    auto echo = (plus | delay(ref(time_samples))) % (_ * ref(feedback));
+    STATIC_REQUIRE(std::same_as<decltype(erased(echo)), Erased<1, 1>>);
+    std::vector<float> x(300);
+    for (std::size_t i = 0; i < x.size(); i++) x[i] = i % 37 == 0 ? 1.f : 0.f;
+
+    SECTION ("Evaluates like the erased block") {
+      auto expected = make_evaluator(echo);
+      auto e = make_evaluator(make_echo() | _ * 2);
+      for (float in : x) REQUIRE(e.eval({in})[0] == 2 * expected.eval({in})[0]);
+    }
+
+    SECTION ("Processes buffers through the erased evaluator") {
+      auto frames = make_evaluator(echo);
+      auto buffers = make_evaluator(make_echo());
+      std::vector<float> out = x;
+      process(buffers, BufferView<1>({out.data()}, out.size()), BufferView<1>({out.data()}, out.size()));
+      for (std::size_t i = 0; i < x.size(); i++) REQUIRE(out[i] == frames.eval({x[i]})[0]);
+    }
+
+    SECTION ("Copies, resets and quiescence") {
+      auto e = make_evaluator(make_echo());
+      REQUIRE(is_quiescent(e));
+      REQUIRE(tail_length(e) == infinite_tail);
+      e.eval({1.f});
+      REQUIRE_FALSE(is_quiescent(e));
+      auto copy = e;
+      for (int i = 0; i < 25; i++) REQUIRE(copy.eval({0.f}) == e.eval({0.f}));
+      auto fresh = clone(e);
+      REQUIRE(is_quiescent(fresh));
+      for (int i = 0; i < 25; i++) REQUIRE(fresh.eval({0.f})[0] == 0);
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,83 @@
+#include "eda/fir_design.hpp"
+#include "eda/resampling.hpp"
+#include "eda/syntax.hpp"
+
+#include <cmath>
+#include <numbers>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  /// Magnitude response of `kernel` at frequency `f`, in dB
+  template<std::size_t N>
+  double response_db(const std::array<float, N>& kernel, double f)
+  {
+    double re = 0;
+    double im = 0;
+    for (std::size_t i = 0; i < N; i++) {
+      re += kernel[i] * std::cos(2 * std::numbers::pi * f * i);
+      im += kernel[i] * std::sin(2 * std::numbers::pi * f * i);
+    }
+    return 20 * std::log10(std::max(std::hypot(re, im), 1e-12));
+  }
+
+  TEST_CASE ("Constexpr math") {
+    for (double x : {-7.0, -1.0, 0.0, 0.3, 2.0, 100.0}) {
+      REQUIRE(std::abs(util::math::sin(x) - std::sin(x)) < 1e-12);
+      REQUIRE(std::abs(util::math::cos(x) - std::cos(x)) < 1e-12);
+    }
+    for (double x : {0.01, 0.5, 2.0, 59.0, 1e6}) {
+      REQUIRE(std::abs(util::math::sqrt(x) - std::sqrt(x)) < 1e-12 * std::sqrt(x));
+      REQUIRE(std::abs(util::math::log(x) - std::log(x)) < 1e-12);
+      REQUIRE(std::abs(util::math::pow(x, 0.4) - std::pow(x, 0.4)) < 1e-12 * std::pow(x, 0.4));
+    }
+    REQUIRE(std::abs(util::math::exp(-3.5) - std::exp(-3.5)) < 1e-15);
+    REQUIRE(std::abs(util::math::bessel_i0(7.857) - std::cyl_bessel_i(0.0, 7.857)) < 1e-9);
+  }
+
+  TEST_CASE ("FIR design") {
+    STATIC_REQUIRE(design::kaiser_taps(80, 0.25) == 23);
+    STATIC_REQUIRE(design::kaiser_halfband_taps(80, 0.375) == 15);
+    STATIC_REQUIRE(std::same_as<decltype(halfband_short), const FIRFilter<23>>);
+
+    SECTION ("Lowpass meets its specification") {
+      constexpr auto filter = design::lowpass<{.cutoff = 0.1, .transition_width = 0.05, .attenuation = 60}>();
+      for (double f = 0; f <= 0.075; f += 0.005) REQUIRE(std::abs(response_db(filter.kernel, f)) < 0.01);
+      for (double f = 0.125; f <= 0.5; f += 0.005) REQUIRE(response_db(filter.kernel, f) < -60);
+    }
+
+    SECTION ("Halfband") {
+      constexpr auto filter = design::halfband<{.cutoff = 0.25, .transition_width = 0.1}>();
+      constexpr auto n = filter.kernel.size();
+      STATIC_REQUIRE(n % 4 == 3);
+      REQUIRE(filter.kernel[0] != 0);
+      REQUIRE(std::abs(filter.kernel[n / 2] - 0.5f) < 1e-3f);
+      for (std::size_t i = 1; i < n / 2; i += 2) REQUIRE(filter.kernel[n / 2 + i + 1] == 0);
+      // Kaiser's estimate may fall short by a dB or two right at the edge of the stopband
+      REQUIRE(response_db(filter.kernel, 0.3) < -78);
+      REQUIRE(response_db(filter.kernel, 0.32) < -80);
+    }
+
+    SECTION ("Windows") {
+      constexpr auto hann = design::windowed_sinc<31>(0.2, design::Hann{});
+      constexpr auto blackman = design::windowed_sinc<31>(0.2, design::Blackman{});
+      REQUIRE(std::abs(response_db(hann, 0) - 0) < 1e-3);
+      // Blackman trades a wider transition for more attenuation
+      REQUIRE(response_db(blackman, 0.4) < response_db(hann, 0.4));
+    }
+
+    SECTION ("Resampling at other ratios") {
+      auto e = make_evaluator(resample<3>(_));
+      float peak = 0;
+      for (int i = 0; i < 2000; i++) {
+        const float out = e.eval({std::sin(i * 0.1f)})[0];
+        if (i > 1000) peak = std::max(peak, std::abs(out));
+      }
+      REQUIRE(std::abs(peak - 1) < 1e-2f);
+    }
+  }
+
+} // namespace eda
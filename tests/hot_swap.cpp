@@ -0,0 +1,77 @@
+#include "eda/hot_swap.hpp"
+#include "eda/syntax.hpp"
+
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("HotSwap") {
+    constexpr std::size_t n = 100;
+    std::vector<float> buffer(n);
+    auto process = [&](HotSwap<1, 1>& swap) {
+      std::ranges::fill(buffer, 1.f);
+      // In place
+      swap.process(BufferView<1>({buffer.data()}, n), BufferView<1>({buffer.data()}, n));
+    };
+
+    SECTION ("Silent until a graph is published") {
+      HotSwap<1, 1> swap(50);
+      process(swap);
+      REQUIRE(buffer[0] == 0);
+      swap.publish(erased(_ * 2));
+      process(swap);
+      REQUIRE_FALSE(swap.swapping());
+      REQUIRE(buffer[0] == 2);
+    }
+
+    SECTION ("Crossfades to the new graph") {
+      HotSwap<1, 1> swap(150);
+      swap.publish(erased(_ * 2));
+      process(swap);
+      swap.publish(erased(_ * 4 + 0));
+      process(swap);
+      REQUIRE(swap.swapping());
+      for (std::size_t i = 0; i < n; i++) REQUIRE(std::abs(buffer[i] - (2 + 2 * (i + 1) / 150.f)) < 1e-5f);
+      process(swap);
+      REQUIRE_FALSE(swap.swapping());
+      for (std::size_t i = 0; i < 50; i++) REQUIRE(std::abs(buffer[i] - (2 + 2 * (i + 101) / 150.f)) < 1e-5f);
+      for (std::size_t i = 50; i < n; i++) REQUIRE(buffer[i] == 4);
+      swap.collect();
+    }
+
+    SECTION ("Only the last published graph is used, and waits for the crossfade") {
+      HotSwap<1, 1> swap(0);
+      swap.publish(erased(_ * 2));
+      swap.publish(erased(_ * 3));
+      process(swap);
+      REQUIRE(buffer[n - 1] == 3);
+
+      HotSwap<1, 1> slow(150);
+      slow.publish(erased(_ * 2));
+      process(slow);
+      slow.publish(erased(_ * 3));
+      process(slow);
+      slow.publish(erased(_ * 5));
+      process(slow);
+      // Still finishing the first crossfade
+      REQUIRE(buffer[n - 1] == 3);
+      process(slow);
+      REQUIRE(std::abs(buffer[n - 1] - (3 + 2 * 100 / 150.f)) < 1e-5f);
+    }
+
+    SECTION ("Keeps state across buffers") {
+      HotSwap<1, 1> swap;
+      swap.publish(erased(mem<1>(_)));
+      for (int i = 0; i < 3; i++) {
+        buffer[0] = 1;
+        swap.process(BufferView<1>({buffer.data()}, 1), BufferView<1>({buffer.data()}, 1));
+      }
+      REQUIRE(buffer[0] == 1);
+    }
+  }
+
+} // namespace eda
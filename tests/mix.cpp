@@ -0,0 +1,59 @@
+#include "eda/mix.hpp"
+#include "eda/parameters.hpp"
+#include "eda/syntax.hpp"
+
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("Mix") {
+    std::array<float, 6> gains = {1, 2, 3, 0.5, 0, -1};
+    auto block = mix<3, 2>(gains);
+    STATIC_REQUIRE(ABlock<decltype(block), 3, 2>);
+    STATIC_REQUIRE(is_stateless_v<decltype(block)>);
+    STATIC_REQUIRE(propagate_dependencies<decltype(block)>({Dependency::constant, Dependency::linear, Dependency::varying}) ==
+                   Dependencies<2>{Dependency::linear, Dependency::linear});
+
+    SECTION ("Frames") {
+      auto e = make_evaluator(block);
+      REQUIRE(e.eval({1, 10, 100}) == Frame<2>{321, -99.5});
+      // The gains are read through the pointer, like a `Ref`
+      gains[5] = 0;
+      REQUIRE(e.eval({1, 10, 100}) == Frame<2>{321, 0.5});
+    }
+
+    SECTION ("Buffers match frames, in place and with a partial block of rows") {
+      std::array<float, 5 * 7> big;
+      for (std::size_t i = 0; i < big.size(); i++) big[i] = 0.1f * (i % 11) - 0.5f;
+      auto e = make_evaluator(mix<7, 5>(big));
+      constexpr std::size_t n = 150;
+      AudioBuffer<7> in(n);
+      for (std::size_t c = 0; c < 7; c++) {
+        for (std::size_t i = 0; i < n; i++) in[c][i] = float(c) - 0.01f * i;
+      }
+      AudioBuffer<7> buf = in;
+      // Outputs are written over the first five inputs
+      BufferView<5> out({buf[0], buf[1], buf[2], buf[3], buf[4]}, n);
+      process(e, buf.view(), out);
+      for (std::size_t i = 0; i < n; i++) {
+        const auto expected = e.eval(in.view().frame(i));
+        for (std::size_t c = 0; c < 5; c++) REQUIRE(std::abs(out[c][i] - expected[c]) < 1e-5f);
+      }
+    }
+
+    SECTION ("Gains from a parameter store") {
+      ParameterStore<8> store({0, 0, 1, 1, 1, -1, 0, 0});
+      auto e = make_evaluator(mix<2, 2>(store.snapshot_values().subspan<2, 4>()));
+      REQUIRE(e.eval({3, 1}) == Frame<2>{4, 2});
+      store.set(5, 1);
+      REQUIRE(e.eval({3, 1}) == Frame<2>{4, 2});
+      store.snapshot();
+      REQUIRE(e.eval({3, 1}) == Frame<2>{4, 4});
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,126 @@
+#include "eda/evaluator.hpp"
+#include "eda/parameters.hpp"
+#include "eda/syntax.hpp"
+
+#include <thread>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("SpscQueue") {
+    util::SpscQueue<int, 4> q;
+    REQUIRE(q.push(1));
+    REQUIRE(q.push(std::array{2, 3}));
+    // Only Capacity - 1 items fit
+    REQUIRE_FALSE(q.push(4));
+    REQUIRE(q.pop() == 1);
+    REQUIRE(q.push(4));
+    REQUIRE(q.pop() == 2);
+    REQUIRE(q.pop() == 3);
+    REQUIRE(q.pop() == 4);
+    REQUIRE(q.pop() == std::nullopt);
+  }
+
+  TEST_CASE ("ParameterStore") {
+    ParameterStore<2> store({1, 10});
+    auto e = make_evaluator(_ * store.ref(0) + store.ref(1));
+    REQUIRE(e.eval({2}) == Frame(12));
+
+    store.set(0, 2);
+    // Not visible until the next snapshot
+    REQUIRE(e.eval({2}) == Frame(12));
+    store.snapshot();
+    REQUIRE(e.eval({2}) == Frame(14));
+
+    SECTION ("Batched updates are applied together") {
+      REQUIRE(store.push(std::array<ParameterUpdate, 2>{{{0, 3}, {1, 20}}}));
+      REQUIRE(store.get(0) == 2);
+      store.snapshot();
+      REQUIRE(store.get(0) == 3);
+      REQUIRE(e.eval({2}) == Frame(26));
+    }
+
+    SECTION ("Later sets win over earlier batches") {
+      REQUIRE(store.push(std::array<ParameterUpdate, 2>{{{0, 3}, {1, 20}}}));
+      store.set(0, 5);
+      store.snapshot();
+      REQUIRE(store.get(0) == 5);
+      REQUIRE(store.get(1) == 20);
+      REQUIRE(e.eval({2}) == Frame(30));
+
+      store.set(1, 30);
+      REQUIRE(store.push({1, 40}));
+      store.snapshot();
+      REQUIRE(store.snapshot_value(1) == 40);
+    }
+
+    SECTION ("Concurrent updates") {
+      store.set(0, 0);
+      store.set(1, 0);
+      std::thread ui([&] {
+        for (int i = 1; i <= 1000; i++) {
+          while (!store.push(std::array<ParameterUpdate, 2>{{{0, float(i)}, {1, float(-i)}}})) {
+            std::this_thread::yield();
+          }
+        }
+      });
+      bool consistent = true;
+      while (store.snapshot_value(0) != 1000) {
+        store.snapshot();
+        consistent &= store.snapshot_value(0) == -store.snapshot_value(1);
+      }
+      ui.join();
+      REQUIRE(consistent);
+      REQUIRE(store.snapshot_value(0) == 1000);
+    }
+  }
+
+  TEST_CASE ("Parameter events") {
+    std::array<float, 2> params = {1, 0};
+    auto e = make_evaluator(_ * ref(params[0]) + ref(params[1]));
+    AudioBuffer<1> buf(8);
+    const auto samples = std::span(buf[0], buf.size());
+    std::ranges::fill(samples, 1.f);
+
+    SECTION ("Changes take effect at their frame") {
+      const std::array<ParameterEvent, 3> events = {{{3, 0, 2}, {3, 1, 10}, {6, 0, 3}}};
+      process_events(e, buf.view(), buf.view(), events, params);
+      REQUIRE(std::ranges::equal(samples, std::array<float, 8>{1, 1, 1, 12, 12, 12, 13, 13}));
+      REQUIRE(params == std::array<float, 2>{3, 10});
+    }
+
+    SECTION ("Events outside of the buffer") {
+      params = {1, 0};
+      std::ranges::fill(samples, 1.f);
+      const std::array<ParameterEvent, 3> events = {{{0, 0, 2}, {8, 0, 5}, {2, 7, 100}}};
+      process_events(e, buf.view(), buf.view(), events, params);
+      REQUIRE(std::ranges::all_of(samples, [](float f) { return f == 2; }));
+      // Applied after processing
+      REQUIRE(params[0] == 5);
+    }
+
+    SECTION ("Smoothed parameters ramp between events") {
+      params = {1, 0};
+      auto s = make_evaluator(_ * smooth(ref(params[0])));
+      process(s, buf.view(), buf.view());
+      std::ranges::fill(samples, 1.f);
+      const std::array<ParameterEvent, 1> events = {{{4, 0, 5}}};
+      process_events(s, buf.view(), buf.view(), events, params);
+      REQUIRE(std::ranges::equal(samples, std::array<float, 8>{1, 1, 1, 1, 2, 3, 4, 5}));
+    }
+
+    SECTION ("ParameterStore") {
+      ParameterStore<1> store({1});
+      auto p = make_evaluator(_ * store.ref(0));
+      std::ranges::fill(samples, 1.f);
+      const std::array<ParameterEvent, 1> events = {{{5, 0, 4}}};
+      process_events(p, buf.view(), buf.view(), events, store.snapshot_values());
+      REQUIRE(samples[4] == 1);
+      REQUIRE(samples[5] == 4);
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,94 @@
+#include "eda/arena.hpp"
+#include "eda/evaluator.hpp"
+#include "eda/pool.hpp"
+#include "eda/syntax.hpp"
+
+#include <thread>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("clone") {
+    auto block = (_ << (_, mem<1>) >> _) | fir<3>({0.5, 0.25, 0.25}) | (2_eda, _) | delay;
+    auto e = make_evaluator(block);
+    for (int i = 0; i < 10; i++) e.eval({float(i)});
+
+    auto fresh = make_evaluator(block);
+    auto copy = clone(e);
+    for (int i = 0; i < 10; i++) REQUIRE(copy.eval({float(i)}) == fresh.eval({float(i)}));
+  }
+
+  TEST_CASE ("EvaluatorPool") {
+    auto pool = make_evaluator_pool(_ << (_, mem<1>) >> _, 2);
+    REQUIRE(pool.size() == 2);
+
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(a.index() != b.index());
+    REQUIRE_FALSE(pool.acquire());
+
+    REQUIRE(a->eval({1}) == Frame(1));
+    REQUIRE(a->eval({1}) == Frame(2));
+
+    SECTION ("Released instances come back reset") {
+      const auto index = a.index();
+      a.release();
+      REQUIRE_FALSE(a);
+      auto c = pool.acquire();
+      REQUIRE(c.index() == index);
+      REQUIRE(c->eval({1}) == Frame(1));
+    }
+
+    SECTION ("Handles release when destroyed") {
+      { auto moved = std::move(b); }
+      REQUIRE(pool.acquire());
+    }
+
+    SECTION ("Arena evaluators") {
+      float time = 2;
+      EvaluatorPool<ArenaEvaluator<decltype(fixed_delay(8)(ref(time)))>> arenas(
+        make_arena_evaluator(fixed_delay(8)(ref(time))), 1);
+      {
+        auto e = arenas.acquire();
+        REQUIRE(e->eval({1}) == Frame(0));
+      }
+      auto e = arenas.acquire();
+      REQUIRE(e->eval({2}) == Frame(0));
+      REQUIRE(e->eval({3}) == Frame(0));
+      REQUIRE(e->eval({4}) == Frame(2));
+    }
+
+    SECTION ("Concurrent acquire and release") {
+      a.release();
+      b.release();
+      std::atomic<int> in_use = 0;
+      std::atomic<bool> overcommitted = false;
+      auto worker = [&] {
+        for (int i = 0; i < 10000; i++) {
+          if (auto h = pool.acquire()) {
+            if (++in_use > 2) overcommitted = true;
+            h->eval({1});
+            --in_use;
+          }
+        }
+      };
+      std::thread t1(worker), t2(worker), t3(worker);
+      t1.join();
+      t2.join();
+      t3.join();
+      REQUIRE_FALSE(overcommitted);
+      auto x = pool.acquire();
+      auto y = pool.acquire();
+      REQUIRE(x);
+      REQUIRE(y);
+      REQUIRE_FALSE(pool.acquire());
+      REQUIRE(x->eval({1}) == Frame(1));
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,129 @@
+#define EDA_RT_CHECK_IMPLEMENTATION
+#include "eda/rt_check.hpp"
+
+#include "eda/convolution.hpp"
+#include "eda/erased.hpp"
+#include "eda/hot_swap.hpp"
+#include "eda/mix.hpp"
+#include "eda/resampling.hpp"
+#include "eda/sample_player.hpp"
+#include "eda/stft.hpp"
+#include "eda/syntax.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  namespace {
+    /// Runs a few buffers of varying sizes through a new evaluator of `block`, and reports the first violation
+    template<AnyBlock Block>
+    RtReport check_block(const Block& block)
+    {
+      auto e = make_evaluator(block);
+      AudioBuffer<ins<Block>> in(256);
+      AudioBuffer<outs<Block>> out(256);
+      for (std::size_t c = 0; c < ins<Block>; c++) {
+        for (std::size_t i = 0; i < 256; i++) in[c][i] = 0.25f * static_cast<float>(i % 7) + 1;
+      }
+      for (std::size_t n : {256, 1, 100, 37}) {
+        const auto report = rt_check_process(e, in.view().subview(0, n), out.view().subview(0, n));
+        if (!report.ok()) return report;
+      }
+      return rt_check_eval(e, in.view().frame(0));
+    }
+  } // namespace
+
+  TEST_CASE ("Real-time safety check") {
+    // Allocations can only be detected with glibc
+    if (!rt_check_supported()) return;
+
+    SECTION ("Detects allocations and locks") {
+      {
+        const RtCheck check;
+        std::vector<float> v(16);
+        std::mutex m;
+        m.lock();
+        m.unlock();
+        const auto report = check.report();
+        REQUIRE(report.allocations == 1);
+        REQUIRE(report.locks == 1);
+      }
+      // Outside of a check
+      std::vector<float> v(16);
+      const RtCheck check;
+      REQUIRE(check.report().ok());
+    }
+
+    SECTION ("Names the block that locked") {
+      static std::mutex m;
+      const auto locking = fun<1, 1>([](Frame<1> in) {
+        const std::lock_guard lock(m);
+        return in;
+      });
+      const auto report = check_block(_ * 0.5f | locking | _ + 1.f);
+      REQUIRE(report.locks > 0);
+      REQUIRE(report.block_name().starts_with("eda::FunBlock<1ul, 1ul,"));
+    }
+
+    SECTION ("Built-in blocks are allocation free after construction") {
+      float param = 0.5f;
+      const std::array<float, 4> gains = {1, 0.5f, 0.5f, 1};
+      const std::array<float, 3> taps = {0.25f, 0.5f, 0.25f};
+      std::vector<float> kernel(300, 0.01f);
+
+      CHECK(check_block((_ + 1) * _ - (_ / 2)).ok());
+      CHECK(check_block(_ * ref(param) + 0.5f).ok());
+      CHECK(check_block(mem<1> | ~_).ok());
+      CHECK(check_block((plus | mem<1>) % (_ * 0.5f)).ok());
+      CHECK(check_block((plus | _ * 0.5f) % _).ok());
+      CHECK(check_block(((_, eda::tanh) | times) % _).ok());
+      CHECK(check_block(_ * smooth(ref(param))).ok());
+      CHECK(check_block(eda::tanh | eda::mod(_, 1.f)).ok());
+      CHECK(check_block(fun<1, 1>([](Frame<1> in, float& s) { return s = 0.5f * s + in[0]; }, 0.f)).ok());
+      CHECK(check_block(fir(taps)).ok());
+      CHECK(check_block(fixed_delay(64)(20.f)).ok());
+      CHECK(check_block((_ * 0.f + 1000.f, _ * 0.5f) | delay).ok());
+      CHECK(check_block(fixed_multitap<2>(64)(10.f, 30.f)).ok());
+      CHECK(check_block(multitap<2>(10.f, 3000.f)).ok());
+      CHECK(check_block(oversample<4>(eda::tanh)).ok());
+      CHECK(check_block(_ | halfband).ok());
+      CHECK(check_block(mix<2, 2>(gains)).ok());
+      CHECK(check_block(convolve(kernel)).ok());
+      CHECK(check_block(stft<64>([](std::span<float> re, std::span<float>) { re[0] = 0; })).ok());
+      CHECK(check_block(erased(_ * 0.5f)).ok());
+    }
+
+    SECTION ("Sample player") {
+      const auto path = std::filesystem::temp_directory_path() / "eda_rt_check_samples.raw";
+      const std::vector<float> ramp(1000, 0.5f);
+      std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(ramp.data()), static_cast<std::streamsize>(ramp.size() * sizeof(float)));
+      auto samples = MappedSamples<>::open_raw(path.c_str());
+      REQUIRE(samples);
+      CHECK(check_block(sample_player(samples)).ok());
+      std::filesystem::remove(path);
+    }
+
+    SECTION ("Hot swap") {
+      HotSwap<1, 1> swap(64);
+      swap.publish(erased(_ * 0.5f));
+      AudioBuffer<1> buf(128);
+      for (int i = 0; i < 3; i++) {
+        if (i == 1) swap.publish(erased(_ * 2.f));
+        const RtCheck check;
+        swap.process(buf.view(), buf.view());
+        REQUIRE(check.report().ok());
+      }
+      swap.collect();
+    }
+  }
+
+} // namespace eda
@@ -0,0 +1,62 @@
+#include "eda/rt_host.hpp"
+#include "eda/syntax.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("Simulated host") {
+    HostOptions options;
+    options.sample_rate = 64000;
+    options.buffer_size = 64;
+
+    SECTION ("Paces callbacks at the buffer rate") {
+      options.callbacks = 20;
+      const auto start = std::chrono::steady_clock::now();
+      const auto stats = simulate_host(_ * 0.5f, options);
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      REQUIRE(stats.deadline == std::chrono::milliseconds(1));
+      REQUIRE(stats.callbacks == 20);
+      REQUIRE(elapsed >= 20 * stats.deadline);
+      REQUIRE(std::accumulate(stats.histogram.begin(), stats.histogram.end(), std::uint64_t(0)) == 20);
+      REQUIRE(stats.worst >= stats.mean());
+      REQUIRE(stats.worst_load() >= stats.mean_load());
+    }
+
+    SECTION ("Counts callbacks that overrun the deadline") {
+      // Sleeps for a third of the deadline per frame
+      const auto slow = fun<1, 1>([](Frame<1> in) {
+        std::this_thread::sleep_for(std::chrono::microseconds(333));
+        return in;
+      });
+      options.callbacks = 5;
+      const auto stats = simulate_host(slow, options);
+      REQUIRE(stats.xruns == 5);
+      REQUIRE(stats.worst_load() > 100);
+      // All in the overflow bin
+      REQUIRE(stats.histogram.back() == 5);
+    }
+
+    SECTION ("Exports the results") {
+      options.callbacks = 20;
+      options.histogram_bins = 4;
+      const auto stats = simulate_host(_ + 1, options);
+      std::ostringstream csv;
+      stats.write_csv(csv);
+      const auto lines = csv.str();
+      REQUIRE(lines.starts_with("start_ns,load_percent,count\n0,0,"));
+      REQUIRE(std::ranges::count(lines, '\n') == 5);
+      std::ostringstream json;
+      stats.write_json(json);
+      REQUIRE(json.str().starts_with("{\"deadline_ns\": 1000000, \"callbacks\": 20, "));
+      REQUIRE(json.str().find("\"bin_width_ns\": 500000, \"histogram\": [") != std::string::npos);
+    }
+  }
+
+} // namespace eda
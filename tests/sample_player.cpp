@@ -0,0 +1,110 @@
+#include "eda/sample_player.hpp"
+#include "eda/syntax.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  namespace {
+    template<typename T>
+    void write_le(std::ofstream& f, T v, std::size_t bytes = sizeof(T))
+    {
+      for (std::size_t i = 0; i < bytes; i++) f.put(static_cast<char>((static_cast<std::uint32_t>(v) >> (8 * i)) & 0xff));
+    }
+
+    /// Write a mono 16 bit WAV file with an extra chunk before the samples
+    void write_wav(const std::filesystem::path& path, const std::vector<std::int16_t>& samples)
+    {
+      std::ofstream f(path, std::ios::binary);
+      const std::uint32_t data_size = samples.size() * 2;
+      f.write("RIFF", 4);
+      write_le(f, 4 + 24 + 10 + 8 + data_size, 4);
+      f.write("WAVEfmt ", 8);
+      write_le(f, 16, 4);
+      write_le(f, 1, 2);
+      write_le(f, 1, 2);
+      write_le(f, 48000, 4);
+      write_le(f, 96000, 4);
+      write_le(f, 2, 2);
+      write_le(f, 16, 2);
+      f.write("LIST", 4);
+      write_le(f, 2, 4);
+      f.write("ab", 2);
+      f.write("data", 4);
+      write_le(f, data_size, 4);
+      for (auto s : samples) write_le(f, static_cast<std::uint16_t>(s), 2);
+    }
+  } // namespace
+
+  TEST_CASE ("Sample player") {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto raw_path = dir / "eda_sample_player.raw";
+    std::vector<float> ramp(1000);
+    for (std::size_t i = 0; i < ramp.size(); i++) ramp[i] = i * 0.001f;
+    std::ofstream(raw_path, std::ios::binary)
+      .write(reinterpret_cast<const char*>(ramp.data()), static_cast<std::streamsize>(ramp.size() * sizeof(float)));
+
+    auto samples = MappedSamples<>::open_raw(raw_path.c_str());
+    REQUIRE(samples);
+    REQUIRE(samples->size() == 1000);
+    REQUIRE((*samples)[500] == ramp[500]);
+    REQUIRE_FALSE(MappedSamples<>::open_raw((dir / "eda_does_not_exist").c_str()));
+    REQUIRE_FALSE(MappedSamples<>::open_raw(raw_path.c_str(), 2));
+
+    SECTION ("Triggering and rate") {
+      auto e = make_evaluator(sample_player(samples));
+      REQUIRE(e.eval({0, 1}) == Frame(0));
+      REQUIRE(e.eval({1, 1}) == Frame(0));
+      REQUIRE(e.eval({1, 0.5}) == Frame(ramp[1]));
+      REQUIRE(std::abs(e.eval({0, 0.5})[0] - 0.0015f) < 1e-6f);
+      // Rising again restarts
+      REQUIRE(e.eval({1, 1}) == Frame(0));
+    }
+
+    SECTION ("Stops after the last sample") {
+      auto e = make_evaluator(sample_player(samples));
+      e.eval({1, 600});
+      REQUIRE(e.eval({1, 600})[0] == ramp[600]);
+      REQUIRE(e.eval({1, 600}) == Frame(0));
+      REQUIRE(is_quiescent(e));
+    }
+
+    SECTION ("Processing buffers matches evaluating frames") {
+      auto frames = make_evaluator(sample_player(samples));
+      auto buffers = make_evaluator(sample_player(samples));
+      std::vector<float> trigger(1500);
+      std::vector<float> rate(1500);
+      for (std::size_t i = 0; i < trigger.size(); i++) {
+        trigger[i] = (i % 700) < 5 ? 1.f : 0.f;
+        rate[i] = i < 300 ? 0.75f : (i < 600 ? 2.5f : 1.f);
+      }
+      std::vector<float> out(1500);
+      process(buffers, BufferView<2>({trigger.data(), rate.data()}, 1500), BufferView<1>({out.data()}, 1500));
+      for (std::size_t i = 0; i < out.size(); i++) {
+        REQUIRE(std::abs(frames.eval({trigger[i], rate[i]})[0] - out[i]) < 1e-6f);
+      }
+    }
+
+    SECTION ("WAV files") {
+      const auto wav_path = dir / "eda_sample_player.wav";
+      write_wav(wav_path, {0, 16384, -16384, 32767});
+      REQUIRE_FALSE(MappedSamples<>::open_wav(wav_path.c_str()));
+      auto wav = MappedSamples<storage::i16>::open_wav(wav_path.c_str());
+      REQUIRE(wav);
+      REQUIRE(wav->size() == 4);
+      REQUIRE(std::abs((*wav)[1] - 0.5f) < 1e-4f);
+      REQUIRE((*wav)[3] == 1.f);
+      std::filesystem::remove(wav_path);
+    }
+
+    std::filesystem::remove(raw_path);
+  }
+
+} // namespace eda
@@ -0,0 +1,79 @@
+#include "eda/stft.hpp"
+#include "eda/syntax.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace eda {
+
+  using namespace syntax;
+
+  TEST_CASE ("STFT") {
+    constexpr std::size_t size = 64;
+    std::vector<float> x(1000);
+    for (std::size_t i = 0; i < x.size(); i++) x[i] = std::sin(i * 0.05f) + 0.5f * std::sin(i * 2.5f);
+    STATIC_REQUIRE(latency<decltype(stft<size>([](std::span<float>, std::span<float>) {}))> == size);
+
+    SECTION ("Resynthesizes its input") {
+      for (std::size_t hop : {size / 2, size / 4}) {
+        auto identity = [](std::span<float>, std::span<float>) {};
+        auto e = hop == size / 2 ? DynEvaluator<1, 1>(make_evaluator(stft<size, size / 2>(identity)))
+                                 : DynEvaluator<1, 1>(make_evaluator(stft<size, size / 4>(identity)));
+        for (std::size_t i = 0; i < x.size(); i++) {
+          const float out = e.eval({x[i]})[0];
+          // The first frames are faded in by the window
+          if (i >= 2 * size) REQUIRE(std::abs(out - x[i - size]) < 1e-4f);
+        }
+      }
+    }
+
+    SECTION ("Processes spectra once per hop") {
+      // Keeps the low frequency sine, and removes the high one
+      int calls = 0;
+      auto e = make_evaluator(stft<size, size / 4>(
+        [](std::span<float> re, std::span<float> im, int*& calls) {
+          (*calls)++;
+          for (std::size_t k = 4; k < re.size(); k++) re[k] = im[k] = 0;
+        },
+        &calls));
+      for (std::size_t i = 0; i < x.size(); i++) {
+        const float out = e.eval({x[i]})[0];
+        if (i >= 2 * size) REQUIRE(std::abs(out - std::sin((i - size) * 0.05f)) < 0.05f);
+      }
+      REQUIRE(calls == x.size() / (size / 4));
+    }
+
+    SECTION ("Processing buffers matches evaluating frames") {
+      auto block = stft<size, size / 4>([](std::span<float> re, std::span<float> im) {
+        for (std::size_t k = 0; k < re.size(); k++) re[k] *= 1.f / (k + 1), im[k] *= 1.f / (k + 1);
+      });
+      auto frames = make_evaluator(block);
+      auto buffers = make_evaluator(block);
+      std::vector<float> out = x;
+      for (std::size_t i = 0, n = 1; i < out.size(); i += n, n = n * 5 % 41 + 1) {
+        n = std::min(n, out.size() - i);
+        process(buffers, BufferView<1>({out.data() + i}, n), BufferView<1>({out.data() + i}, n));
+      }
+      for (std::size_t i = 0; i < x.size(); i++) REQUIRE(frames.eval({x[i]})[0] == out[i]);
+    }
+
+    SECTION ("Reset restores the state of the spectral function") {
+      auto e = make_evaluator(stft<size>(
+        [](std::span<float> re, std::span<float>, int& frames) {
+          // Outputs silence after the first frame
+          if (frames++ > 0) std::ranges::fill(re, 0.f);
+        },
+        0));
+      for (std::size_t i = 0; i < 4 * size; i++) e.eval({1.f});
+      REQUIRE(e.eval({1.f})[0] == 0);
+      e.reset();
+      float peak = 0;
+      for (std::size_t i = 0; i < 2 * size; i++) peak = std::max(peak, e.eval({1.f})[0]);
+      REQUIRE(peak > 0);
+    }
+  }
+
+} // namespace eda